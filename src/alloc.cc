@@ -0,0 +1,178 @@
+#include "alloc.h"
+
+#include <malloc.h>
+
+#include <cstdlib>
+#include <new>
+
+// Replacement global operator new/delete for -DAOC_ALLOC=ON builds. Sizes
+// come from malloc_usable_size so that unsized deletes balance the books.
+namespace Aoc::Alloc::detail {
+
+ProcessCounters process;
+thread_local constinit Counters thread;
+
+namespace {
+
+void count_alloc(void* p)
+{
+    const auto size{static_cast<int64_t>(malloc_usable_size(p))};
+
+    ++thread.allocs;
+    thread.bytes += size;
+    thread.live += size;
+    thread.peak = std::max(thread.peak, thread.live);
+
+    process.allocs.fetch_add(1, std::memory_order_relaxed);
+    process.bytes.fetch_add(size, std::memory_order_relaxed);
+    const int64_t live{process.live.fetch_add(size, std::memory_order_relaxed) + size};
+    int64_t peak{process.peak.load(std::memory_order_relaxed)};
+    while (peak < live && !process.peak.compare_exchange_weak(peak, live, std::memory_order_relaxed)) { }
+}
+
+
+void count_free(void* p)
+{
+    const auto size{static_cast<int64_t>(malloc_usable_size(p))};
+    thread.live -= size;
+    process.live.fetch_sub(size, std::memory_order_relaxed);
+}
+
+
+void* allocate(size_t size, size_t align = 0)
+{
+    size = std::max<size_t>(size, 1);
+    void* p{align ? std::aligned_alloc(align, (size + align - 1) / align * align) : std::malloc(size)};
+    if (p) {
+        count_alloc(p);
+    }
+    return p;
+}
+
+
+void* allocate_or_throw(size_t size, size_t align = 0)
+{
+    void* p{allocate(size, align)};
+    if (!p) {
+        throw std::bad_alloc{};
+    }
+    return p;
+}
+
+
+void release(void* p) noexcept
+{
+    if (p) {
+        count_free(p);
+        std::free(p);
+    }
+}
+
+}  // namespace
+
+}  // namespace Aoc::Alloc::detail
+
+
+using Aoc::Alloc::detail::allocate;
+using Aoc::Alloc::detail::allocate_or_throw;
+using Aoc::Alloc::detail::release;
+
+void* operator new(size_t size)
+{
+    return allocate_or_throw(size);
+}
+
+void* operator new[](size_t size)
+{
+    return allocate_or_throw(size);
+}
+
+void* operator new(size_t size, std::align_val_t align)
+{
+    return allocate_or_throw(size, static_cast<size_t>(align));
+}
+
+void* operator new[](size_t size, std::align_val_t align)
+{
+    return allocate_or_throw(size, static_cast<size_t>(align));
+}
+
+void* operator new(size_t size, std::nothrow_t const&) noexcept
+{
+    return allocate(size);
+}
+
+void* operator new[](size_t size, std::nothrow_t const&) noexcept
+{
+    return allocate(size);
+}
+
+void* operator new(size_t size, std::align_val_t align, std::nothrow_t const&) noexcept
+{
+    return allocate(size, static_cast<size_t>(align));
+}
+
+void* operator new[](size_t size, std::align_val_t align, std::nothrow_t const&) noexcept
+{
+    return allocate(size, static_cast<size_t>(align));
+}
+
+void operator delete(void* p) noexcept
+{
+    release(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    release(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    release(p);
+}
+
+void operator delete[](void* p, size_t) noexcept
+{
+    release(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept
+{
+    release(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept
+{
+    release(p);
+}
+
+void operator delete(void* p, size_t, std::align_val_t) noexcept
+{
+    release(p);
+}
+
+void operator delete[](void* p, size_t, std::align_val_t) noexcept
+{
+    release(p);
+}
+
+void operator delete(void* p, std::nothrow_t const&) noexcept
+{
+    release(p);
+}
+
+void operator delete[](void* p, std::nothrow_t const&) noexcept
+{
+    release(p);
+}
+
+void operator delete(void* p, std::align_val_t, std::nothrow_t const&) noexcept
+{
+    release(p);
+}
+
+void operator delete[](void* p, std::align_val_t, std::nothrow_t const&) noexcept
+{
+    release(p);
+}
@@ -0,0 +1,296 @@
+#pragma once
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Heap accounting through replaced global operator new/delete (alloc.cc,
+// linked in with -DAOC_ALLOC=ON). A scope reports the number of allocations,
+// the bytes requested and the peak of live bytes above what was live when
+// it was entered:
+//
+//   AOC_ALLOC_SCOPE("day2/invalid_ids");
+//
+// Named scopes count the allocations of their own thread, the per-day phases
+// count the whole process so that work handed to TBB is included. Recursive
+// functions only count the outermost call. Without the option the scopes
+// compile to nothing.
+namespace Aoc::Alloc {
+
+struct Counters
+{
+    uint64_t allocs{0};
+    uint64_t bytes{0};
+    int64_t live{0};  // memory freed by another thread makes this go negative
+    int64_t peak{0};
+};
+
+struct Totals
+{
+    uint64_t calls{0};
+    uint64_t allocs{0};
+    uint64_t bytes{0};
+    int64_t peak{0};  // largest peak of a single call
+};
+
+enum class Reach
+{
+    Thread,
+    Process
+};
+
+#if AOC_ALLOC
+
+inline constexpr bool enabled{true};
+
+namespace detail {
+
+struct ProcessCounters
+{
+    std::atomic<uint64_t> allocs{0};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<int64_t> live{0};
+    std::atomic<int64_t> peak{0};
+};
+
+// defined in alloc.cc next to operator new
+extern ProcessCounters process;
+extern thread_local constinit Counters thread;
+
+}  // namespace detail
+
+
+// Nesting depth and totals of one thread, merged into the registry when the
+// thread exits.
+struct ThreadTotals
+{
+    std::vector<Totals> sites;
+    std::vector<uint32_t> depth;
+
+    ThreadTotals();
+    ~ThreadTotals();
+
+    static ThreadTotals& local()
+    {
+        thread_local ThreadTotals totals;
+        return totals;
+    }
+};
+
+
+class Registry
+{
+    std::mutex mutex;
+    std::deque<std::string> names;
+    std::vector<Totals> finished;
+    std::vector<ThreadTotals const*> running;
+
+    static void add(std::vector<Totals>& to, std::vector<Totals> const& from)
+    {
+        to.resize(std::max(to.size(), from.size()));
+        for (size_t i{0}; i < from.size(); ++i) {
+            to[i].calls += from[i].calls;
+            to[i].allocs += from[i].allocs;
+            to[i].bytes += from[i].bytes;
+            to[i].peak = std::max(to[i].peak, from[i].peak);
+        }
+    }
+
+public:
+    // never destroyed: pool threads may exit after the static destructors ran
+    static Registry& instance()
+    {
+        static Registry* registry{new Registry};
+        return *registry;
+    }
+
+    size_t site(std::string_view name)
+    {
+        const std::lock_guard lock{mutex};
+        for (size_t i{0}; i < names.size(); ++i) {
+            if (names[i] == name) {
+                return i;
+            }
+        }
+        names.emplace_back(name);
+        return names.size() - 1;
+    }
+
+    void attach(ThreadTotals const* t)
+    {
+        const std::lock_guard lock{mutex};
+        running.push_back(t);
+    }
+
+    void detach(ThreadTotals const* t)
+    {
+        const std::lock_guard lock{mutex};
+        add(finished, t->sites);
+        std::erase(running, t);
+    }
+
+    // Names and totals of all sites over all threads so far. Threads still
+    // running are read without stopping them, call it between runs.
+    std::vector<std::pair<std::string, Totals>> snapshot()
+    {
+        const std::lock_guard lock{mutex};
+        std::vector<Totals> all{finished};
+        for (auto const* t : running) {
+            add(all, t->sites);
+        }
+
+        std::vector<std::pair<std::string, Totals>> result;
+        for (size_t i{0}; i < names.size(); ++i) {
+            result.emplace_back(names[i], i < all.size() ? all[i] : Totals{});
+        }
+        return result;
+    }
+};
+
+
+inline ThreadTotals::ThreadTotals()
+{
+    Registry::instance().attach(this);
+}
+
+inline ThreadTotals::~ThreadTotals()
+{
+    Registry::instance().detach(this);
+}
+
+
+inline size_t site(std::string_view name)
+{
+    return Registry::instance().site(name);
+}
+
+
+class Scope
+{
+    ThreadTotals& totals;
+    size_t id;
+    Reach reach;
+    bool outermost;
+    Counters start{};
+
+    Counters now() const
+    {
+        if (reach == Reach::Thread) {
+            return detail::thread;
+        }
+        return {.allocs = detail::process.allocs.load(std::memory_order_relaxed),
+                .bytes = detail::process.bytes.load(std::memory_order_relaxed),
+                .live = detail::process.live.load(std::memory_order_relaxed),
+                .peak = detail::process.peak.load(std::memory_order_relaxed)};
+    }
+
+    // restarts the peak at the current live bytes, returns the old peak
+    int64_t reset_peak() const
+    {
+        if (reach == Reach::Thread) {
+            return std::exchange(detail::thread.peak, detail::thread.live);
+        }
+        return detail::process.peak.exchange(detail::process.live.load(std::memory_order_relaxed));
+    }
+
+    void restore_peak(int64_t peak) const
+    {
+        if (reach == Reach::Thread) {
+            detail::thread.peak = std::max(detail::thread.peak, peak);
+            return;
+        }
+        int64_t current{detail::process.peak.load(std::memory_order_relaxed)};
+        while (current < peak && !detail::process.peak.compare_exchange_weak(current, peak)) { }
+    }
+
+public:
+    explicit Scope(size_t site_id, Reach r = Reach::Thread)
+        : totals {ThreadTotals::local()}
+        , id {site_id}
+        , reach {r}
+    {
+        if (totals.sites.size() <= id) {
+            totals.sites.resize(id + 1);
+            totals.depth.resize(id + 1);
+        }
+        ++totals.sites[id].calls;
+        outermost = totals.depth[id]++ == 0;
+        if (outermost) {
+            start = now();
+            start.peak = reset_peak();
+        }
+    }
+
+    Scope(Scope const&) = delete;
+    Scope& operator=(Scope const&) = delete;
+
+    ~Scope()
+    {
+        --totals.depth[id];
+        if (!outermost) {
+            return;
+        }
+
+        const auto end{now()};
+        auto& t{totals.sites[id]};
+        t.allocs += end.allocs - start.allocs;
+        t.bytes += end.bytes - start.bytes;
+        t.peak = std::max(t.peak, end.peak - start.live);
+        restore_peak(start.peak);
+    }
+};
+
+
+// Table of all sites with at least one call.
+inline void report(std::FILE* out = stdout)
+{
+    fmt::print(out, "{:<32} {:>10} {:>14} {:>16} {:>16}\n", "scope", "calls", "allocations", "bytes", "peak bytes");
+    for (auto const& [name, t] : Registry::instance().snapshot()) {
+        if (t.calls) {
+            fmt::print(out, "{:<32} {:>10} {:>14} {:>16} {:>16}\n", name, t.calls, t.allocs, t.bytes, t.peak);
+        }
+    }
+}
+
+#define AOC_ALLOC_CAT_(a, b) a##b
+#define AOC_ALLOC_CAT(a, b) AOC_ALLOC_CAT_(a, b)
+#define AOC_ALLOC_SCOPE(name)                                                                \
+    static const size_t AOC_ALLOC_CAT(aoc_alloc_site_, __LINE__){::Aoc::Alloc::site(name)}; \
+    const ::Aoc::Alloc::Scope AOC_ALLOC_CAT(aoc_alloc_scope_, __LINE__)                     \
+    {                                                                                        \
+        AOC_ALLOC_CAT(aoc_alloc_site_, __LINE__)                                             \
+    }
+
+#else
+
+inline constexpr bool enabled{false};
+
+inline size_t site(std::string_view)
+{
+    return 0;
+}
+
+struct Scope
+{
+    explicit Scope(size_t, Reach = Reach::Thread) { }
+};
+
+inline void report(std::FILE* out = stdout)
+{
+    fmt::print(out, "allocation accounting not built in, configure with -DAOC_ALLOC=ON\n");
+}
+
+#define AOC_ALLOC_SCOPE(name) static_cast<void>(0)
+
+#endif
+
+}  // namespace Aoc::Alloc
@@ -0,0 +1,471 @@
+#include "day.h"
+#include "alloc.h"
+#include "arena.h"
+#include "batch.h"
+#include "input.h"
+#include "perf.h"
+#include "scanner.h"
+#include "timing.h"
+#include "trace.h"
+
+#include <fmt/core.h>
+
+#include <oneapi/tbb/info.h>
+#include <oneapi/tbb/task_arena.h>
+#include <oneapi/tbb/task_group.h>
+
+#include <algorithm>
+#include <any>
+#include <array>
+#include <cstdio>
+#include <deque>
+#include <exception>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+struct Options
+{
+    std::string input_dir{"."};
+    unsigned repeat{1};
+    unsigned warmup{0};
+    bool counters{false};
+    bool heap{false};
+    std::string trace;           // set: file for the Chrome trace
+    std::optional<int> threads;  // set: all days at once on a TBB arena
+    std::string batch;           // set: inputs pattern for batch mode
+    bool answers{false};
+    bool builtin{false};
+    std::vector<unsigned> days;
+};
+
+
+void usage(const char* argv0)
+{
+    fmt::print(stderr,
+               "Usage: {} [-i DIR] [-e] [-r REPEAT] [-w WARMUP] [-p] [-m] [-t FILE] [-j THREADS] [-b PATTERN [-a]] [DAY | FROM-TO]...\n"
+               "  -i DIR     directory with dayN.txt inputs (default .)\n"
+               "  -e         days built with AOC_EMBED solve their compiled-in input\n"
+               "             instead of DIR/dayN.txt, without a runtime parse\n"
+               "  -r REPEAT  timed runs per phase (default 1)\n"
+               "  -w WARMUP  untimed runs before measuring (default 0)\n"
+               "  -p         print hardware counters per phase and AOC_SCOPE site\n"
+               "  -m         print allocations and peak heap per phase and AOC_SCOPE site\n"
+               "  -t FILE    write the phases, AOC_SCOPE sites and day10 machines of all\n"
+               "             runs to FILE as Chrome trace events (Perfetto, chrome://tracing)\n"
+               "  -j THREADS run all days and both parts concurrently on one TBB arena\n"
+               "             of THREADS threads (0 = all cores) and report the makespan\n"
+               "  -b PATTERN batch mode: solve every input in a directory or glob, {{}} is\n"
+               "             replaced by the day (-b 'inputs/day{{}}/*.txt'); with -j the\n"
+               "             inputs of a day are solved in parallel\n"
+               "  -a         with -b, print the answers of each input\n"
+               "Without days all registered days are run.\n",
+               argv0);
+}
+
+
+std::optional<Options> parse_args(int argc, char** argv)
+{
+    Options opts;
+
+    for (int i{1}; i < argc; ++i) {
+        const std::string_view arg{argv[i]};
+
+        if (arg == "-h" || arg == "--help") {
+            return std::nullopt;
+        }
+        if (arg == "-p") {
+            opts.counters = true;
+            continue;
+        }
+        if (arg == "-m") {
+            opts.heap = true;
+            continue;
+        }
+        if (arg == "-a") {
+            opts.answers = true;
+            continue;
+        }
+        if (arg == "-e") {
+            opts.builtin = true;
+            continue;
+        }
+        if (arg == "-i" || arg == "-r" || arg == "-w" || arg == "-j" || arg == "-b" || arg == "-t") {
+            if (++i == argc) {
+                return std::nullopt;
+            }
+            if (arg == "-i") {
+                opts.input_dir = argv[i];
+            }
+            else if (arg == "-r") {
+                opts.repeat = std::max(1u, Aoc::to_int<unsigned>(argv[i]));
+            }
+            else if (arg == "-j") {
+                opts.threads = Aoc::to_int<int>(argv[i]);
+            }
+            else if (arg == "-b") {
+                opts.batch = argv[i];
+            }
+            else if (arg == "-t") {
+                opts.trace = argv[i];
+            }
+            else {
+                opts.warmup = Aoc::to_int<unsigned>(argv[i]);
+            }
+            continue;
+        }
+
+        Aoc::Scanner scan{arg};
+        unsigned from{0}, to{0};
+        if (!scan.next(from)) {
+            return std::nullopt;
+        }
+        if (!arg.contains('-') || !scan.next(to)) {
+            to = from;
+        }
+        for (unsigned d{from}; d <= to; ++d) {
+            opts.days.push_back(d);
+        }
+    }
+
+    if (opts.days.empty()) {
+        for (auto const& day : Aoc::days()) {
+            opts.days.push_back(day.number);
+        }
+        std::ranges::sort(opts.days);
+    }
+
+    return opts;
+}
+
+
+void print_row(unsigned day, std::string_view phase, std::optional<Aoc::Answer> answer, Aoc::Stats const& s)
+{
+    fmt::print("{:>3} {:<6} {:>20} {:>12.3f} {:>12.3f} {:>12.3f}\n",
+               day,
+               phase,
+               answer ? fmt::format("{}", *answer) : std::string{},
+               s.min.count(),
+               s.median.count(),
+               s.max.count());
+}
+
+
+// Runs all phases of one day, returns the sum of the median phase times.
+Aoc::Duration run_day(Aoc::Day const& day, Options const& opts)
+{
+    const bool builtin{opts.builtin && day.builtin};
+    std::optional<Aoc::MappedInput> input;
+    if (!builtin) {
+        input.emplace(fmt::format("{}/day{}.txt", opts.input_dir, day.number));
+    }
+
+    const auto times{Aoc::measure(day, input ? input->data() : std::string_view{}, opts.warmup, opts.repeat, builtin)};
+
+    const auto s_parse{Aoc::summarize(times.parse)};
+    const auto s_part1{Aoc::summarize(times.part1)};
+    const auto s_part2{Aoc::summarize(times.part2)};
+
+    print_row(day.number, "parse", std::nullopt, s_parse);
+    print_row(day.number, "part1", times.answer1, s_part1);
+    if (day.part2) {
+        print_row(day.number, "part2", times.answer2, s_part2);
+    }
+
+    return s_parse.median + s_part1.median + s_part2.median;
+}
+
+
+struct DayRun
+{
+    // without a path the day solves its compiled-in input
+    DayRun(Aoc::Day const& d, std::optional<std::string> const& path)
+        : day {&d}
+        , sites {{{d.number, "parse"}, {d.number, "part1"}, {d.number, "part2"}}}
+    {
+        if (path) {
+            input.emplace(*path);
+        }
+    }
+
+    Aoc::Day const* day;
+    std::optional<Aoc::MappedInput> input;
+    std::array<Aoc::PhaseScope::Site, 3> sites;
+    std::vector<Aoc::Duration> parse, part1, part2;
+    Aoc::Answer answer1{0}, answer2{0};
+    std::string error;
+    Aoc::RunArena memory;
+    // the parts run at the same time, a monotonic arena is not thread safe
+    std::array<Aoc::RunArena, 2> part_memory;
+};
+
+
+// One run of all days: a task per day parses, then part1 and part2 run as
+// two more tasks on the same arena, so long days overlap the short ones.
+// Whichever thread runs a phase installs that day's RunArena for it.
+void run_all(tbb::task_arena& arena, std::deque<DayRun>& runs, bool measured)
+{
+    auto phase = [measured](std::vector<Aoc::Duration>& times, Aoc::PhaseScope::Site const& site, auto&& fn)
+    {
+        auto [result, duration] {Aoc::timed(
+                [&]
+                {
+                    const Aoc::PhaseScope scope{site};
+                    return fn();
+                })};
+        if (measured) {
+            times.push_back(duration);
+        }
+        return std::move(result);
+    };
+
+    arena.execute(
+            [&]
+            {
+                tbb::task_group days;
+                for (auto& r : runs) {
+                    days.run(
+                            [&r, &phase]
+                            {
+                                r.memory.reset();
+                                for (auto& m : r.part_memory) {
+                                    m.reset();
+                                }
+                                const Aoc::RunArena::Use use{r.memory};
+                                try {
+                                    const std::any parsed{
+                                            phase(r.parse,
+                                                  r.sites[0],
+                                                  [&r] { return r.input ? r.day->parse(r.input->data()) : r.day->builtin(); })};
+
+                                    tbb::task_group parts;
+                                    parts.run(
+                                            [&]
+                                            {
+                                                const Aoc::RunArena::Use part_use{r.part_memory[0]};
+                                                r.answer1 = phase(r.part1, r.sites[1], [&] { return r.day->part1(parsed); });
+                                            });
+                                    if (r.day->part2) {
+                                        parts.run(
+                                                [&]
+                                                {
+                                                    const Aoc::RunArena::Use part_use{r.part_memory[1]};
+                                                    r.answer2 = phase(
+                                                            r.part2, r.sites[2], [&] { return r.day->part2(parsed); });
+                                                });
+                                    }
+                                    parts.wait();
+                                }
+                                catch (std::exception const& e) {
+                                    r.error = e.what();
+                                }
+                            });
+                }
+                days.wait();
+            });
+}
+
+
+// Runs all days concurrently, returns the median makespan.
+Aoc::Duration run_concurrent(std::vector<Aoc::Day const*> const& days, Options const& opts, int& status)
+{
+    const int threads{*opts.threads > 0 ? *opts.threads : tbb::info::default_concurrency()};
+    tbb::task_arena arena{threads};
+
+    std::deque<DayRun> runs;
+    for (auto const* day : days) {
+        try {
+            if (opts.builtin && day->builtin) {
+                runs.emplace_back(*day, std::nullopt);
+            }
+            else {
+                runs.emplace_back(*day, fmt::format("{}/day{}.txt", opts.input_dir, day->number));
+            }
+        }
+        catch (std::exception const& e) {
+            fmt::print(stderr, "Day {}: {}\n", day->number, e.what());
+            status = 1;
+        }
+    }
+
+    std::vector<Aoc::Duration> makespans;
+    for (unsigned run{0}; run < opts.warmup + opts.repeat; ++run) {
+        const bool measured{run >= opts.warmup};
+        const auto start{Aoc::Clock::now()};
+        run_all(arena, runs, measured);
+        const Aoc::Duration makespan{Aoc::Clock::now() - start};
+        if (measured) {
+            makespans.push_back(makespan);
+        }
+    }
+
+    Aoc::Duration busy{}, slowest{};
+    for (auto const& r : runs) {
+        if (!r.error.empty()) {
+            fmt::print(stderr, "Day {}: {}\n", r.day->number, r.error);
+            status = 1;
+            continue;
+        }
+
+        const auto s_parse{Aoc::summarize(r.parse)};
+        const auto s_part1{Aoc::summarize(r.part1)};
+        const auto s_part2{Aoc::summarize(r.part2)};
+
+        print_row(r.day->number, "parse", std::nullopt, s_parse);
+        print_row(r.day->number, "part1", r.answer1, s_part1);
+        if (r.day->part2) {
+            print_row(r.day->number, "part2", r.answer2, s_part2);
+        }
+
+        busy += s_parse.median + s_part1.median + s_part2.median;
+        slowest = std::max(slowest, s_parse.median + std::max(s_part1.median, s_part2.median));
+    }
+
+    const auto s_makespan{Aoc::summarize(makespans)};
+    fmt::print("makespan on {} thread(s): min {:.3f} ms, median {:.3f} ms, max {:.3f} ms\n",
+               threads,
+               s_makespan.min.count(),
+               s_makespan.median.count(),
+               s_makespan.max.count());
+    fmt::print("slowest day (parse + slower part): {:.3f} ms\n", slowest.count());
+
+    return busy;
+}
+
+
+// Writes what Aoc::Trace recorded to opts.trace.
+void write_trace(Options const& opts, int& status)
+{
+    if constexpr (!Aoc::Trace::enabled) {
+        fmt::print(stderr, "tracing not built in, configure with -DAOC_TRACE=ON\n");
+        status = 1;
+        return;
+    }
+
+    std::FILE* out{std::fopen(opts.trace.c_str(), "w")};
+    if (!out) {
+        fmt::print(stderr, "Unable to write {}\n", opts.trace);
+        status = 1;
+        return;
+    }
+    Aoc::Trace::write(out);
+    std::fclose(out);
+}
+
+
+// Solves all inputs matching opts.batch for one day, returns the elapsed time.
+Aoc::Duration run_batch(Aoc::Day const& day, Options const& opts, int& status)
+{
+    std::string pattern{opts.batch};
+    for (size_t pos{pattern.find("{}")}; pos != std::string::npos; pos = pattern.find("{}", pos)) {
+        pattern.replace(pos, 2, std::to_string(day.number));
+    }
+
+    const auto paths{Aoc::batch_inputs(pattern)};
+    if (paths.empty()) {
+        fmt::print(stderr, "Day {}: no inputs match {}\n", day.number, pattern);
+        status = 1;
+        return {};
+    }
+
+    const auto result{Aoc::solve_batch(day, paths, opts.threads.value_or(1))};
+
+    for (auto const& item : result.items) {
+        if (!item.error.empty()) {
+            fmt::print(stderr, "Day {} {}: {}\n", day.number, item.path, item.error);
+            status = 1;
+        }
+        else if (opts.answers) {
+            fmt::print("{:>3} {} {} {}\n", day.number, item.path, item.answer1, item.answer2);
+        }
+    }
+
+    const double seconds{result.elapsed.count() / 1000};
+    fmt::print("{:>3} {} inputs, {} bytes in {:.3f} ms: {:.1f} inputs/s, {:.3f} MB/s{}\n",
+               day.number,
+               result.items.size(),
+               result.bytes,
+               result.elapsed.count(),
+               result.items.size() / seconds,
+               result.bytes / seconds / 1e6,
+               result.failed ? fmt::format(", {} failed", result.failed) : "");
+
+    return result.elapsed;
+}
+
+}  // namespace
+
+
+int main(int argc, char** argv)
+{
+    const auto opts{parse_args(argc, argv)};
+    if (!opts) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    Aoc::Duration total{};
+    int status{0};
+
+    std::vector<Aoc::Day const*> days;
+    for (unsigned number : opts->days) {
+        auto const* day{Aoc::find_day(number)};
+        if (!day) {
+            fmt::print(stderr, "Day {} is not available\n", number);
+            status = 1;
+            continue;
+        }
+        days.push_back(day);
+    }
+
+    if (!opts->trace.empty()) {
+        Aoc::Trace::start();
+    }
+
+    if (!opts->batch.empty()) {
+        for (auto const* day : days) {
+            total += run_batch(*day, *opts, status);
+        }
+        fmt::print("total: {:.3f} ms\n", total.count());
+        if (!opts->trace.empty()) {
+            write_trace(*opts, status);
+        }
+        return status;
+    }
+
+    fmt::print("{:>3} {:<6} {:>20} {:>12} {:>12} {:>12}\n", "day", "phase", "answer", "min ms", "median ms", "max ms");
+
+    if (opts->threads) {
+        total = run_concurrent(days, *opts, status);
+    }
+    else {
+        for (auto const* day : days) {
+            try {
+                total += run_day(*day, *opts);
+            }
+            catch (std::exception const& e) {
+                fmt::print(stderr, "Day {}: {}\n", day->number, e.what());
+                status = 1;
+            }
+        }
+    }
+
+    fmt::print("total (sum of medians): {:.3f} ms, {} run(s), {} warmup\n", total.count(), opts->repeat, opts->warmup);
+
+    if (opts->counters) {
+        fmt::print("\n");
+        Aoc::Perf::report();
+    }
+    if (opts->heap) {
+        fmt::print("\n");
+        Aoc::Alloc::report();
+    }
+    if (!opts->trace.empty()) {
+        write_trace(*opts, status);
+    }
+
+    return status;
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <utility>
+
+// Per-run memory for the parsed inputs. Days allocate their long-lived
+// structures (std::pmr containers) from run_resource(); the runner installs
+// a RunArena around each run and resets it afterwards, which drops all of
+// them at once instead of freeing node by node. Outside a run, and on any
+// thread that has no arena installed, run_resource() is the global heap, so
+// copies and temporaries made in TBB workers never touch the arena.
+namespace Aoc {
+
+namespace detail {
+
+inline std::pmr::memory_resource*& current_resource() noexcept
+{
+    thread_local std::pmr::memory_resource* resource{std::pmr::new_delete_resource()};
+    return resource;
+}
+
+}  // namespace detail
+
+
+inline std::pmr::memory_resource* run_resource() noexcept
+{
+    return detail::current_resource();
+}
+
+
+// Monotonic arena over a buffer that is kept between runs. When a run needs
+// more than the buffer, the next reset() grows it to what that run used, so
+// a batch of similar inputs settles on a single allocation.
+class RunArena
+{
+    // counts what the monotonic resource had to get beyond the buffer
+    class Overflow : public std::pmr::memory_resource
+    {
+    public:
+        size_t bytes{0};
+
+    private:
+        void* do_allocate(size_t n, size_t align) override
+        {
+            bytes += n;
+            return std::pmr::new_delete_resource()->allocate(n, align);
+        }
+
+        void do_deallocate(void* p, size_t n, size_t align) override
+        {
+            std::pmr::new_delete_resource()->deallocate(p, n, align);
+        }
+
+        bool do_is_equal(memory_resource const& o) const noexcept override { return this == &o; }
+    };
+
+    size_t capacity;
+    std::unique_ptr<std::byte[]> buffer;
+    Overflow overflow;
+    std::optional<std::pmr::monotonic_buffer_resource> resource;
+
+public:
+    explicit RunArena(size_t initial = 64 * 1024)
+        : capacity {initial}
+        , buffer {std::make_unique_for_overwrite<std::byte[]>(initial)}
+    {
+        resource.emplace(buffer.get(), capacity, &overflow);
+    }
+
+    RunArena(RunArena const&) = delete;
+    RunArena& operator=(RunArena const&) = delete;
+
+    std::pmr::memory_resource* get() noexcept { return &*resource; }
+
+    size_t size() const noexcept { return capacity; }
+
+    // Frees everything allocated since the last reset. Nothing allocated
+    // from the arena may be alive.
+    void reset()
+    {
+        resource.reset();
+        if (overflow.bytes) {
+            capacity += overflow.bytes;
+            buffer = std::make_unique_for_overwrite<std::byte[]>(capacity);
+            overflow.bytes = 0;
+        }
+        resource.emplace(buffer.get(), capacity, &overflow);
+    }
+
+    // Makes the arena the run_resource() of the calling thread for a scope.
+    class Use
+    {
+        std::pmr::memory_resource* previous;
+
+    public:
+        explicit Use(RunArena& arena) noexcept
+            : previous {std::exchange(detail::current_resource(), arena.get())}
+        { }
+
+        Use(Use const&) = delete;
+        Use& operator=(Use const&) = delete;
+
+        ~Use() { detail::current_resource() = previous; }
+    };
+};
+
+}  // namespace Aoc
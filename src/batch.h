@@ -0,0 +1,126 @@
+#pragma once
+
+#include "arena.h"
+#include "day.h"
+#include "input.h"
+#include "timing.h"
+
+#include <glob.h>
+
+#include <oneapi/tbb/enumerable_thread_specific.h>
+#include <oneapi/tbb/parallel_for.h>
+#include <oneapi/tbb/task_arena.h>
+
+#include <algorithm>
+#include <exception>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Many inputs of one day solved in a single process, for throughput rather
+// than latency.
+namespace Aoc {
+
+// Regular files of a directory, or the matches of a glob pattern, sorted.
+inline std::vector<std::string> batch_inputs(std::string const& pattern)
+{
+    std::vector<std::string> paths;
+
+    if (std::filesystem::is_directory(pattern)) {
+        for (auto const& entry : std::filesystem::directory_iterator{pattern}) {
+            if (entry.is_regular_file()) {
+                paths.push_back(entry.path().string());
+            }
+        }
+    }
+    else {
+        glob_t matches{};
+        if (::glob(pattern.c_str(), 0, nullptr, &matches) == 0) {
+            for (size_t i{0}; i < matches.gl_pathc; ++i) {
+                paths.emplace_back(matches.gl_pathv[i]);
+            }
+        }
+        ::globfree(&matches);
+    }
+
+    std::ranges::sort(paths);
+    return paths;
+}
+
+
+struct BatchResult
+{
+    struct Item
+    {
+        std::string path;
+        size_t bytes{0};
+        Answer answer1{0}, answer2{0};
+        std::string error;  // empty when solved
+    };
+
+    std::vector<Item> items;
+    size_t bytes{0};
+    size_t failed{0};
+    Duration elapsed{};
+};
+
+// Maps, parses and solves every input. With threads > 1 the inputs are
+// spread over a TBB arena of that many threads, 0 means all cores. Each
+// thread reuses one RunArena, reset before every input.
+inline BatchResult solve_batch(Day const& day, std::vector<std::string> const& paths, int threads = 1)
+{
+    BatchResult result;
+    result.items.resize(paths.size());
+
+    tbb::enumerable_thread_specific<RunArena> memory;
+
+    auto solve = [&](size_t i)
+    {
+        auto& item{result.items[i]};
+        item.path = paths[i];
+
+        // isolated, so that a day using TBB itself cannot pick up another
+        // input on this thread while the arena is in use
+        tbb::this_task_arena::isolate(
+                [&]
+                {
+                    auto& arena{memory.local()};
+                    arena.reset();
+                    const RunArena::Use use{arena};
+                    try {
+                        const MappedInput input{paths[i]};
+                        item.bytes = input.data().size();
+                        const auto parsed{day.parse(input.data())};
+                        item.answer1 = day.part1(parsed);
+                        if (day.part2) {
+                            item.answer2 = day.part2(parsed);
+                        }
+                    }
+                    catch (std::exception const& e) {
+                        item.error = e.what();
+                    }
+                });
+    };
+
+    const auto start{Clock::now()};
+    if (threads == 1) {
+        for (size_t i{0}; i < paths.size(); ++i) {
+            solve(i);
+        }
+    }
+    else {
+        tbb::task_arena arena{threads > 0 ? threads : tbb::task_arena::automatic};
+        arena.execute([&] { tbb::parallel_for(size_t{0}, paths.size(), solve); });
+    }
+    result.elapsed = Clock::now() - start;
+
+    for (auto const& item : result.items) {
+        result.bytes += item.bytes;
+        result.failed += !item.error.empty();
+    }
+
+    return result;
+}
+
+}  // namespace Aoc
@@ -0,0 +1,530 @@
+#include "day.h"
+#include "generators.h"
+#include "input.h"
+#include "scanner.h"
+#include "timing.h"
+
+#include <fmt/core.h>
+#include <fmt/os.h>
+
+#include <algorithm>
+#include <any>
+#include <array>
+#include <charconv>
+#include <exception>
+#include <functional>
+#include <map>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+struct Options
+{
+    std::vector<unsigned> days;
+    unsigned repeat{3};
+    unsigned warmup{1};
+    uint64_t seed{2025};
+    unsigned factor{2};
+    size_t max_n{0};           // 0 = generator default
+    double budget_ms{2000.0};  // stop a sweep once one size takes longer than this
+    bool json{false};
+    std::string output;
+    std::string baseline;  // write raw samples here
+    std::string compare;   // re-run the sizes of this baseline and test for regressions
+    double threshold{5.0}; // percent the median may grow before it counts as a regression
+    bool diff{false};      // reference against registered engines instead of a sweep
+};
+
+
+void usage(const char* argv0)
+{
+    fmt::print(stderr,
+               "Usage: {} [-r REPEAT] [-w WARMUP] [-s SEED] [-f FACTOR] [-n MAX_N] [-b BUDGET_MS]\n"
+               "          [--json] [-o FILE] [--baseline FILE] [--compare FILE [-t PERCENT]] [--diff]\n"
+               "          [DAY | FROM-TO]...\n"
+               "Sweeps each day over generated inputs of geometrically growing size and\n"
+               "writes time versus size as CSV (default) or JSON.\n"
+               "  --baseline FILE  also write every sample of the sweep to FILE\n"
+               "  --compare FILE   re-run the days and sizes of a baseline instead of a\n"
+               "                   sweep; exits with 1 when a phase is significantly slower\n"
+               "                   (one-sided Mann-Whitney U, p < 0.05) and its median grew\n"
+               "                   by more than PERCENT (default 5). Use -r 5 or more for\n"
+               "                   both runs, fewer samples can never be significant.\n"
+               "  --diff           sweep the days that kept a reference engine, running it\n"
+               "                   next to the registered one on every size; prints the\n"
+               "                   speedup and exits with 1 when any answer differs.\n",
+               argv0);
+}
+
+
+std::optional<Options> parse_args(int argc, char** argv)
+{
+    Options opts;
+
+    for (int i{1}; i < argc; ++i) {
+        const std::string_view arg{argv[i]};
+
+        if (arg == "-h" || arg == "--help") {
+            return std::nullopt;
+        }
+        if (arg == "--json") {
+            opts.json = true;
+            continue;
+        }
+        if (arg == "--diff") {
+            opts.diff = true;
+            continue;
+        }
+        if (arg == "--baseline" || arg == "--compare") {
+            if (++i == argc) {
+                return std::nullopt;
+            }
+            (arg == "--baseline" ? opts.baseline : opts.compare) = argv[i];
+            continue;
+        }
+        if (arg.size() == 2 && arg[0] == '-') {
+            if (++i == argc) {
+                return std::nullopt;
+            }
+            const std::string_view value{argv[i]};
+            switch (arg[1]) {
+                case 'r': opts.repeat = std::max(1u, Aoc::to_int<unsigned>(value)); break;
+                case 'w': opts.warmup = Aoc::to_int<unsigned>(value); break;
+                case 's': opts.seed = Aoc::to_int<uint64_t>(value); break;
+                case 'f': opts.factor = std::max(2u, Aoc::to_int<unsigned>(value)); break;
+                case 'n': opts.max_n = Aoc::to_int<size_t>(value); break;
+                case 'b': opts.budget_ms = Aoc::to_int<unsigned>(value); break;
+                case 'o': opts.output = value; break;
+                case 't': opts.threshold = Aoc::to_int<unsigned>(value); break;
+                default: return std::nullopt;
+            }
+            continue;
+        }
+
+        Aoc::Scanner scan{arg};
+        unsigned from{0}, to{0};
+        if (!scan.next(from)) {
+            return std::nullopt;
+        }
+        if (!arg.contains('-') || !scan.next(to)) {
+            to = from;
+        }
+        for (unsigned d{from}; d <= to; ++d) {
+            opts.days.push_back(d);
+        }
+    }
+
+    return opts;
+}
+
+
+struct Sample
+{
+    unsigned day;
+    size_t n;
+    size_t bytes;
+    std::string_view phase;
+    Aoc::Stats stats;
+    std::vector<Aoc::Duration> times;
+};
+
+
+constexpr std::string_view phase_names[] {"parse", "part1", "part2"};
+
+
+void write_csv(fmt::ostream& out, std::vector<Sample> const& samples)
+{
+    out.print("day,n,bytes,phase,min_ms,median_ms,max_ms\n");
+    for (auto const& s : samples) {
+        out.print("{},{},{},{},{:.6f},{:.6f},{:.6f}\n",
+                  s.day,
+                  s.n,
+                  s.bytes,
+                  s.phase,
+                  s.stats.min.count(),
+                  s.stats.median.count(),
+                  s.stats.max.count());
+    }
+}
+
+
+void write_json(fmt::ostream& out, std::vector<Sample> const& samples)
+{
+    out.print("[\n");
+    for (auto const& [idx, s] : std::views::enumerate(samples)) {
+        out.print("  {{\"day\": {}, \"n\": {}, \"bytes\": {}, \"phase\": \"{}\", "
+                  "\"min_ms\": {:.6f}, \"median_ms\": {:.6f}, \"max_ms\": {:.6f}}}{}\n",
+                  s.day,
+                  s.n,
+                  s.bytes,
+                  s.phase,
+                  s.stats.min.count(),
+                  s.stats.median.count(),
+                  s.stats.max.count(),
+                  idx + 1 < std::ssize(samples) ? "," : "");
+    }
+    out.print("]\n");
+}
+
+
+// Measures one generated size, adds a sample per phase and returns the sum
+// of the phase medians, or nothing when the day failed on this size.
+std::optional<Aoc::Duration> measure_size(
+        Aoc::Day const& day,
+        Aoc::Gen::Generator const& gen,
+        size_t n,
+        uint64_t seed,
+        unsigned warmup,
+        unsigned repeat,
+        std::vector<Sample>& samples)
+{
+    const std::string input{gen.make(n, seed)};
+
+    Aoc::PhaseTimes times;
+    try {
+        times = Aoc::measure(day, input, warmup, repeat);
+    }
+    catch (std::exception const& e) {
+        fmt::print(stderr, "day {} n={}: {}\n", gen.day, n, e.what());
+        return std::nullopt;
+    }
+
+    Aoc::Duration total{};
+    for (auto const& [phase, t] : std::views::zip(phase_names, std::array{&times.parse, &times.part1, &times.part2})) {
+        if (t->empty()) {
+            continue;
+        }
+        const auto stats{Aoc::summarize(*t)};
+        samples.push_back({.day = gen.day, .n = n, .bytes = input.size(), .phase = phase, .stats = stats, .times = *t});
+        total += stats.median;
+    }
+
+    fmt::print(stderr, "day {:>2} {:>10} {:<9} {:>12.3f} ms\n", gen.day, n, gen.unit, total.count());
+    return total;
+}
+
+
+Aoc::Gen::Generator const* find_generator(unsigned day)
+{
+    auto const all{Aoc::Gen::generators()};
+    auto it{std::ranges::find(all, day, &Aoc::Gen::Generator::day)};
+    return it != all.end() ? &*it : nullptr;
+}
+
+
+void sweep(Aoc::Gen::Generator const& gen, Options const& opts, std::vector<Sample>& samples)
+{
+    auto const* day{Aoc::find_day(gen.day)};
+    if (!day) {
+        return;
+    }
+
+    const size_t max_n{opts.max_n ? opts.max_n : gen.max_n};
+
+    for (size_t n{gen.min_n}; n <= max_n; n *= opts.factor) {
+        const auto total{measure_size(*day, gen, n, opts.seed, opts.warmup, opts.repeat, samples)};
+        if (!total || total->count() > opts.budget_ms) {
+            break;
+        }
+    }
+}
+
+
+// Baseline file: a "seed N" line, then one line per day, size and phase
+// with all samples in milliseconds:
+//   day n bytes phase ms ms ms ...
+void write_baseline(std::string const& path, uint64_t seed, std::vector<Sample> const& samples)
+{
+    auto out{fmt::output_file(path)};
+    out.print("seed {}\n", seed);
+    for (auto const& s : samples) {
+        out.print("{} {} {} {}", s.day, s.n, s.bytes, s.phase);
+        for (auto const& t : s.times) {
+            out.print(" {:.6f}", t.count());
+        }
+        out.print("\n");
+    }
+}
+
+
+struct Baseline
+{
+    uint64_t seed{0};
+    std::vector<Sample> samples;
+};
+
+Baseline read_baseline(std::string const& path)
+{
+    const Aoc::MappedInput file{path};
+    Baseline baseline;
+
+    for (std::string_view line : file.lines()) {
+        std::vector<std::string_view> fields;
+        for (auto const& f : line | std::views::split(' ')) {
+            if (!f.empty()) {
+                fields.emplace_back(f.begin(), f.end());
+            }
+        }
+        if (fields.size() == 2 && fields[0] == "seed") {
+            baseline.seed = Aoc::to_int<uint64_t>(fields[1]);
+            continue;
+        }
+        if (fields.size() < 5) {
+            continue;
+        }
+
+        Sample s{.day = Aoc::to_int<unsigned>(fields[0]), .n = Aoc::to_int<size_t>(fields[1]), .bytes = Aoc::to_int<size_t>(fields[2])};
+        if (auto it{std::ranges::find(phase_names, fields[3])}; it != std::end(phase_names)) {
+            s.phase = *it;
+        }
+        for (auto f : fields | std::views::drop(4)) {
+            double ms{0};
+            std::from_chars(f.data(), f.data() + f.size(), ms);
+            s.times.emplace_back(ms);
+        }
+        s.stats = Aoc::summarize(s.times);
+        baseline.samples.push_back(std::move(s));
+    }
+
+    return baseline;
+}
+
+
+// Re-runs every day and size of the baseline, prints the comparison and
+// returns whether any phase regressed.
+bool compare(Options const& opts)
+{
+    constexpr double alpha{0.05};
+
+    const auto baseline{read_baseline(opts.compare)};
+
+    // day, n -> samples of the baseline
+    std::map<std::pair<unsigned, size_t>, std::vector<Sample const*>> sizes;
+    for (auto const& s : baseline.samples) {
+        if (opts.days.empty() || std::ranges::find(opts.days, s.day) != opts.days.end()) {
+            sizes[{s.day, s.n}].push_back(&s);
+        }
+    }
+
+    fmt::print("{:>3} {:>10} {:<6} {:>12} {:>12} {:>8} {:>8}  {}\n",
+               "day", "n", "phase", "base ms", "now ms", "change", "p", "verdict");
+
+    bool regressed{false};
+    for (auto const& [key, before] : sizes) {
+        auto const& [day_number, n] {key};
+        auto const* day{Aoc::find_day(day_number)};
+        auto const* gen{find_generator(day_number)};
+        if (!day || !gen) {
+            continue;
+        }
+
+        unsigned repeat{opts.repeat};
+        for (auto const* s : before) {
+            repeat = std::max<unsigned>(repeat, s->times.size());
+        }
+
+        std::vector<Sample> now;
+        measure_size(*day, *gen, n, baseline.seed, opts.warmup, repeat, now);
+
+        for (auto const* b : before) {
+            auto it{std::ranges::find(now, b->phase, &Sample::phase)};
+            if (it == now.end()) {
+                fmt::print("{:>3} {:>10} {:<6} {:>12.3f} {:>12} {:>8} {:>8}  failed\n",
+                           b->day, b->n, b->phase, b->stats.median.count(), "-", "-", "-");
+                regressed = true;
+                continue;
+            }
+
+            const double change{(it->stats.median / b->stats.median - 1) * 100};
+            const double p{Aoc::mann_whitney_slower(b->times, it->times)};
+            const bool slower{p < alpha && change > opts.threshold};
+            regressed |= slower;
+
+            fmt::print("{:>3} {:>10} {:<6} {:>12.3f} {:>12.3f} {:>+7.1f}% {:>8.3f}  {}\n",
+                       b->day,
+                       b->n,
+                       b->phase,
+                       b->stats.median.count(),
+                       it->stats.median.count(),
+                       change,
+                       p,
+                       slower ? "REGRESSION" : "ok");
+        }
+    }
+
+    return regressed;
+}
+
+
+using Part = std::function<Aoc::Answer(std::any const&)>;
+
+struct EngineRun
+{
+    std::array<Aoc::Answer, 2> answers{};
+    std::array<std::vector<Aoc::Duration>, 2> times;
+};
+
+// Parses the input and runs the given parts warmup + repeat times, with a
+// fresh RunArena every run as in Aoc::measure(). Only the parts are timed.
+EngineRun run_engine(
+        Aoc::Day const& day,
+        std::array<Part const*, 2> parts,
+        std::string_view input,
+        unsigned warmup,
+        unsigned repeat)
+{
+    EngineRun result;
+    Aoc::RunArena arena;
+
+    for (unsigned run{0}; run < warmup + repeat; ++run) {
+        arena.reset();
+        const Aoc::RunArena::Use use{arena};
+        const auto parsed{day.parse(input)};
+
+        for (size_t i{0}; i < parts.size(); ++i) {
+            if (!*parts[i]) {
+                continue;
+            }
+            const auto [answer, d] {Aoc::timed([&] { return (*parts[i])(parsed); })};
+            result.answers[i] = answer;
+            if (run >= warmup) {
+                result.times[i].push_back(d);
+            }
+        }
+    }
+
+    return result;
+}
+
+
+// Runs the reference and the registered engine of a day on one generated
+// size and prints a line per part. Returns the reference's median time over
+// both parts, or nothing when an engine failed or an answer differs.
+std::optional<Aoc::Duration> diff_size(
+        Aoc::Day const& day,
+        Aoc::Gen::Generator const& gen,
+        size_t n,
+        Options const& opts,
+        bool& mismatch)
+{
+    const std::string input{gen.make(n, opts.seed)};
+    const Part none;
+    auto const& ref{day.reference};
+
+    EngineRun before, now;
+    try {
+        before = run_engine(day, {&ref.part1, &ref.part2}, input, opts.warmup, opts.repeat);
+        now = run_engine(day, {&day.part1, ref.part2 ? &day.part2 : &none}, input, opts.warmup, opts.repeat);
+    }
+    catch (std::exception const& e) {
+        fmt::print("{:>3} {:>10} {:<9} {:>5}  failed: {}\n", day.number, n, gen.unit, "-", e.what());
+        mismatch = true;
+        return std::nullopt;
+    }
+
+    Aoc::Duration total{};
+    bool same{true};
+    for (size_t i{0}; i < before.times.size(); ++i) {
+        if (before.times[i].empty()) {
+            continue;
+        }
+        const auto ref_ms{Aoc::summarize(before.times[i]).median};
+        const auto now_ms{Aoc::summarize(now.times[i]).median};
+        total += ref_ms;
+
+        const bool agree{before.answers[i] == now.answers[i]};
+        same &= agree;
+        fmt::print("{:>3} {:>10} {:<9} {:>5} {:>12.3f} {:>12.3f} {:>9.2f}x  ",
+                   day.number,
+                   n,
+                   gen.unit,
+                   i + 1,
+                   ref_ms.count(),
+                   now_ms.count(),
+                   ref_ms / std::max(now_ms, Aoc::Duration{1e-6}));
+        if (agree) {
+            fmt::print("ok\n");
+        }
+        else {
+            fmt::print("MISMATCH {} != {}\n", before.answers[i], now.answers[i]);
+        }
+    }
+
+    mismatch |= !same;
+    return same ? std::optional{total} : std::nullopt;
+}
+
+
+// Sweeps every selected day that has a reference engine until the reference
+// alone takes longer than the budget, returns whether anything differed.
+bool diff(Options const& opts)
+{
+    fmt::print("{:>3} {:>10} {:<9} {:>5} {:>12} {:>12} {:>10}  {}\n",
+               "day", "n", "unit", "part", "ref ms", "opt ms", "speedup", "verdict");
+
+    bool mismatch{false};
+    for (auto const& gen : Aoc::Gen::generators()) {
+        if (!opts.days.empty() && std::ranges::find(opts.days, gen.day) == opts.days.end()) {
+            continue;
+        }
+        auto const* day{Aoc::find_day(gen.day)};
+        if (!day || !day->reference.part1) {
+            continue;
+        }
+
+        const size_t max_n{opts.max_n ? opts.max_n : gen.max_n};
+        for (size_t n{gen.min_n}; n <= max_n; n *= opts.factor) {
+            const auto total{diff_size(*day, gen, n, opts, mismatch)};
+            if (!total || total->count() > opts.budget_ms) {
+                break;
+            }
+        }
+    }
+
+    return mismatch;
+}
+
+}  // namespace
+
+
+int main(int argc, char** argv)
+{
+    const auto opts{parse_args(argc, argv)};
+    if (!opts) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    if (!opts->compare.empty()) {
+        return compare(*opts) ? 1 : 0;
+    }
+    if (opts->diff) {
+        return diff(*opts) ? 1 : 0;
+    }
+
+    std::vector<Sample> samples;
+
+    for (auto const& gen : Aoc::Gen::generators()) {
+        if (opts->days.empty() || std::ranges::find(opts->days, gen.day) != opts->days.end()) {
+            sweep(gen, *opts, samples);
+        }
+    }
+
+    auto out{fmt::output_file(opts->output.empty() ? "/dev/stdout" : opts->output)};
+    if (opts->json) {
+        write_json(out, samples);
+    }
+    else {
+        write_csv(out, samples);
+    }
+
+    if (!opts->baseline.empty()) {
+        write_baseline(opts->baseline, opts->seed, samples);
+    }
+
+    return 0;
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <algorithm>
+#include <any>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Aoc {
+
+using Answer = uint64_t;
+
+// Incremental solver for days whose input can be consumed line by line with
+// state that does not grow with the input (dayN -s). line() returns false
+// once the rest of the input does not matter; the answers are those of the
+// lines seen so far.
+class LineSolver
+{
+public:
+    virtual ~LineSolver() = default;
+
+    virtual bool line(std::string_view line) = 0;
+
+    virtual Answer part1() const = 0;
+    virtual Answer part2() const = 0;
+};
+
+// The engine a day used before it was optimised, kept so that rewrites can
+// be checked against it: its parts take the day's parsed input like the
+// day's own ones (aoc_bench --diff runs both and compares).
+struct Reference
+{
+    std::function<Answer(std::any const&)> part1;
+    std::function<Answer(std::any const&)> part2;  // empty for days with a single part
+};
+
+// One puzzle split into separately callable phases. parse() returns the
+// day's own input type wrapped in std::any, the parts take it back by
+// const reference, so the same parsed input can be solved repeatedly.
+struct Day
+{
+    unsigned number{0};
+
+    std::function<std::any(std::string_view)> parse;
+    std::function<Answer(std::any const&)> part1;
+    std::function<Answer(std::any const&)> part2;  // empty for days with a single part
+    std::function<std::any()> builtin;              // set when the input is compiled in (AOC_EMBED)
+    std::function<std::unique_ptr<LineSolver>()> stream;  // set for days that can stream
+    std::function<std::pair<Answer, Answer>(std::string_view)> scan;  // set for days that can scan in parallel
+    Reference reference;                                  // set for days that keep their previous engine
+};
+
+template<typename Input>
+std::function<Answer(std::any const&)> make_part(Answer (*part)(Input const&))
+{
+    if (!part) {
+        return {};
+    }
+    return [part](std::any const& input) { return part(std::any_cast<Input const&>(input)); };
+}
+
+template<typename Input>
+Day make_day(
+        unsigned number,
+        Input (*parse)(std::string_view),
+        Answer (*part1)(Input const&),
+        Answer (*part2)(std::type_identity_t<Input> const&) = nullptr,
+        Input (*builtin)() = nullptr)
+{
+    Day day;
+    day.number = number;
+    day.parse = [parse](std::string_view data) -> std::any { return parse(data); };
+    day.part1 = make_part(part1);
+    day.part2 = make_part<Input>(part2);
+    if (builtin) {
+        day.builtin = [builtin]() -> std::any { return builtin(); };
+    }
+    return day;
+}
+
+inline std::vector<Day>& days()
+{
+    static std::vector<Day> registry;
+    return registry;
+}
+
+inline Day const* find_day(unsigned number)
+{
+    auto it{std::ranges::find(days(), number, &Day::number)};
+    return it != days().end() ? &*it : nullptr;
+}
+
+// Adds a day to the registry during static initialisation:
+//   const Aoc::Register registered{1, day1::parse, day1::part1, day1::part2};
+struct Register
+{
+    template<typename Input>
+    Register(
+            unsigned number,
+            Input (*parse)(std::string_view),
+            Answer (*part1)(Input const&),
+            Answer (*part2)(std::type_identity_t<Input> const&) = nullptr,
+            Input (*builtin)() = nullptr)
+    {
+        days().push_back(make_day(number, parse, part1, part2, builtin));
+    }
+};
+
+// Adds a streaming solver to a day registered before it in the same file:
+//   const Aoc::RegisterStream<day1::Stream> streamed{1};
+template<typename Solver>
+struct RegisterStream
+{
+    explicit RegisterStream(unsigned number)
+    {
+        std::ranges::find(days(), number, &Day::number)->stream = [] { return std::make_unique<Solver>(); };
+    }
+};
+
+// Adds a parallel scan to a day registered before it in the same file: it
+// solves both parts straight from the raw input, split into chunks that are
+// reduced on all cores (dayN -p):
+//   const Aoc::RegisterScan scanned{1, day1::scan};
+struct RegisterScan
+{
+    RegisterScan(unsigned number, std::pair<Answer, Answer> (*scan)(std::string_view))
+    {
+        std::ranges::find(days(), number, &Day::number)->scan = scan;
+    }
+};
+
+// Adds the reference engine of a day registered before it in the same file:
+//   const Aoc::RegisterReference reference{2, day2::reference::part1, day2::reference::part2};
+struct RegisterReference
+{
+    template<typename Input>
+    RegisterReference(
+            unsigned number,
+            Answer (*part1)(Input const&),
+            Answer (*part2)(std::type_identity_t<Input> const&) = nullptr)
+    {
+        std::ranges::find(days(), number, &Day::number)->reference = {make_part(part1), make_part<Input>(part2)};
+    }
+};
+
+}  // namespace Aoc
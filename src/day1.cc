@@ -1,45 +1,372 @@
-#include <fmt/core.h>
+#include "day.h"
+#include "input.h"
+#include "scanner.h"
+#include "simd.h"
 
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
+#include <oneapi/tbb/parallel_reduce.h>
+#include <oneapi/tbb/task_arena.h>
+
+#include <algorithm>
 #include <cassert>
-#include <iostream>
+#include <cstdint>
+#include <cstdlib>
+#include <iterator>
+#include <numeric>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace day1 {
+
+// signed click counts, L is negative
+using Rotations = std::vector<int64_t>;
+
+// at most 10^18 - 1 clicks, well inside int64_t
+constexpr size_t max_count_digits{18};
+
+// "L41" or "R25"; the count ends at the first non-digit, e.g. a '\r'.
+int64_t rotation(std::string_view line)
+{
+    size_t n{1};
+    while (n < line.size() && line[n] >= '0' && line[n] <= '9') {
+        ++n;
+    }
+    if (n == 1 || n > max_count_digits + 1) {
+        throw std::runtime_error(std::string{"Bad rotation: "} + std::string{line});
+    }
+
+    const auto ptr{static_cast<int64_t>(Aoc::Simd::digits(line.substr(1, n - 1)))};
+    return line[0] == 'L' ? -ptr : ptr;
+}
 
-int main()
+// a line without the '\r' of a CRLF file, so its blank line is empty
+constexpr std::string_view content(std::string_view line)
 {
-    int dial{50};
+    if (!line.empty() && line.back() == '\r') {
+        line.remove_suffix(1);
+    }
+    return line;
+}
 
-    unsigned zeros1{0}, zeros2{0};
+Rotations parse(std::string_view data)
+{
+    Rotations rotations;
 
-    std::string line;
-    while (std::getline(std::cin, line)) {
+    while (!data.empty()) {
+        const size_t eol{Aoc::Simd::find_newline(data)};
+        const std::string_view line{content(data.substr(0, eol))};
         if (line.empty()) {
             break;
         }
+        data.remove_prefix(std::min(eol + 1, data.size()));
+        rotations.push_back(rotation(line));
+    }
+
+    return rotations;
+}
+
+
+// A dial of size positions, 0 to size - 1, pointing at pos. The puzzle's
+// has 100 and starts at 50; AOC_DAY1_DIAL=SIZE[,START] sets another.
+struct Dial
+{
+    int64_t size{100};
+    int64_t pos{50};
+
+    static Dial configured()
+    {
+        static const Dial dial{[]
+        {
+            Dial d;
+            if (const char* env{std::getenv("AOC_DAY1_DIAL")}; env && *env) {
+                Aoc::Scanner scan{env};
+                if (!scan.next(d.size) || d.size <= 0) {
+                    throw std::runtime_error("AOC_DAY1_DIAL: size must be positive");
+                }
+                if (!scan.next(d.pos)) {
+                    d.pos = d.size / 2;
+                }
+                if (d.pos < 0 || d.pos >= d.size) {
+                    throw std::runtime_error("AOC_DAY1_DIAL: start must be below the size");
+                }
+            }
+            return d;
+        }()};
+        return dial;
+    }
+
+    // Turns the dial by a signed number of clicks, returns how many of them
+    // landed on zero. Clicks to the right reach zero at every multiple of
+    // size above pos, to the left at the multiples below it: both are
+    // counted as whole laps from the last zero before pos in that direction.
+    uint64_t turn(int64_t rotation)
+    {
+        const int64_t back{rotation < 0 ? (size - pos) % size : pos};
+        const int64_t clicks{rotation < 0 ? -rotation : rotation};
+
+        pos = ((pos + rotation) % size + size) % size;
+        return static_cast<uint64_t>((back + clicks) / size);
+    }
+};
 
-        int ptr = std::stoi(&line[1]);
-        int sign{1};
 
-        if (line.at(0) == 'L') {
-            sign = -1;
+Aoc::Answer part1(Rotations const& rotations)
+{
+    Dial dial{Dial::configured()};
+    uint64_t zeros{0};
+
+    for (const int64_t r : rotations) {
+        dial.turn(r);
+        if (dial.pos == 0) {
+            ++zeros;
         }
+    }
+
+    return zeros;
+}
+
+Aoc::Answer part2(Rotations const& rotations)
+{
+    Dial dial{Dial::configured()};
+    uint64_t zeros{0};
+
+    for (const int64_t r : rotations) {
+        zeros += dial.turn(r);
+    }
+
+    return zeros;
+}
+
 
-        for (int i{0}; i < ptr; ++i) {
-            dial = dial + (sign * 1);
-            if (dial >= 100)
-                dial -= 100;
-            if (dial < 0)
-                dial += 100;
-            if (dial == 0)
-                ++zeros2;
+// Both parts turn the same dial, so one pass answers both.
+class Stream : public Aoc::LineSolver
+{
+    Dial dial{Dial::configured()};
+    uint64_t stops{0}, clicks{0};
+
+public:
+    bool line(std::string_view line) override
+    {
+        if (content(line).empty()) {
+            return false;
         }
+        clicks += dial.turn(rotation(line));
+        stops += dial.pos == 0;
+        return true;
+    }
+
+    Aoc::Answer part1() const override { return stops; }
+    Aoc::Answer part2() const override { return clicks; }
+};
+
+
+// Floor division and modulo by a positive divisor.
+constexpr int64_t floor_div(int64_t a, int64_t b)
+{
+    return a / b - (a % b != 0 && a < 0);
+}
+
+constexpr int64_t floor_mod(int64_t a, int64_t b)
+{
+    return a - floor_div(a, b) * b;
+}
+
 
-        if (dial == 0) {
-            ++zeros1;
+// Dials larger than this are scanned on one core, a piece keeps two
+// counters per dial position.
+constexpr int64_t max_scan_size{1 << 16};
+
+// A piece of the log reduced for every position p the dial could enter it
+// at. Relative to p the dial moves by the same clicks whatever p is, so
+// the stops at zero are a histogram of those relative positions. Each
+// rotation passes zero floor((p + q) / size) times for a few q, that is
+// floor(q / size) plus one if p >= size - q mod size: the clicks past zero
+// are a constant plus a difference array over p.
+struct Piece
+{
+    int64_t turn{0};              // net clicks, modulo the dial size
+    int64_t laps{0};
+    std::vector<uint64_t> stops;  // by entry position
+    std::vector<int64_t> steps;   // laps gained from this entry position up
+    bool last{false};             // ends at an empty line, which ends the input
+
+    Piece() = default;
+
+    Piece(std::string_view text, int64_t size)
+        : stops(size, 0)
+        , steps(size, 0)
+    {
+        // the clicks past zero of a turn are lap(end) - lap(start)
+        auto lap = [&](int64_t q, int64_t sign)
+        {
+            laps += sign * floor_div(q, size);
+            if (const int64_t m{floor_mod(q, size)}) {
+                steps[size - m] += sign;
+            }
+        };
+
+        while (!text.empty()) {
+            const size_t eol{Aoc::Simd::find_newline(text)};
+            const std::string_view line{content(text.substr(0, eol))};
+            if (line.empty()) {
+                last = true;
+                break;
+            }
+            text.remove_prefix(std::min(eol + 1, text.size()));
+
+            const int64_t r{rotation(line)};
+            if (r >= 0) {
+                lap(turn + r, 1);
+                lap(turn, -1);
+            }
+            else {
+                // to the left zero is passed on the way down to turn + r
+                lap(turn - 1, 1);
+                lap(turn + r - 1, -1);
+            }
+            turn = floor_mod(turn + r, size);
+            ++stops[floor_mod(-turn, size)];
+        }
+    }
+
+    std::pair<Aoc::Answer, Aoc::Answer> answers(int64_t entry) const
+    {
+        int64_t clicks{laps};
+        for (int64_t p{0}; p <= entry; ++p) {
+            clicks += steps[p];
+        }
+        return {stops[entry], static_cast<Aoc::Answer>(clicks)};
+    }
+};
+
+
+// Both parts in one parallel pass over the raw log: pieces of about eight
+// per thread, cut at line starts, are reduced independently; an exclusive
+// scan of their net turns gives each the position the dial enters it at,
+// then the answers of the pieces are summed in parallel.
+std::pair<Aoc::Answer, Aoc::Answer> scan(std::string_view data)
+{
+    const Dial start{Dial::configured()};
+    const int64_t size{start.size};
+
+    if (size > max_scan_size) {
+        Stream stream;
+        Aoc::Lines lines{data};
+        for (auto it{lines.begin()}; it != lines.end() && stream.line(*it); ++it) { }
+        return {stream.part1(), stream.part2()};
+    }
+
+    const auto threads{static_cast<size_t>(tbb::this_task_arena::max_concurrency())};
+    const size_t length{std::max<size_t>(1 << 20, data.size() / (threads * 8) + 1)};
+
+    // piece i is [bounds[i], bounds[i + 1])
+    std::vector<size_t> bounds{0};
+    while (bounds.back() < data.size()) {
+        const size_t next{bounds.back() + length};
+        if (next >= data.size()) {
+            bounds.push_back(data.size());
+            break;
         }
+        const size_t eol{next - 1 + Aoc::Simd::find_newline(data.substr(next - 1))};
+        bounds.push_back(std::min(eol + 1, data.size()));
+    }
+
+    std::vector<Piece> pieces(bounds.size() - 1);
+    tbb::parallel_for(size_t{0},
+                      pieces.size(),
+                      [&](size_t i) { pieces[i] = Piece{data.substr(bounds[i], bounds[i + 1] - bounds[i]), size}; });
+
+    // nothing after the first empty line counts
+    if (auto it{std::ranges::find(pieces, true, &Piece::last)}; it != pieces.end()) {
+        pieces.erase(std::next(it), pieces.end());
     }
 
-    fmt::print("1: {}\n", zeros1);
-    fmt::print("2: {}\n", zeros2);
+    std::vector<int64_t> entries(pieces.size());
+    std::transform_exclusive_scan(
+            pieces.begin(),
+            pieces.end(),
+            entries.begin(),
+            start.pos,
+            [size](int64_t a, int64_t b) { return (a + b) % size; },
+            [](Piece const& p) { return p.turn; });
 
-    return 0;
+    using Answers = std::pair<Aoc::Answer, Aoc::Answer>;
+    return tbb::parallel_reduce(
+            tbb::blocked_range<size_t>{0, pieces.size()},
+            Answers{0, 0},
+            [&](tbb::blocked_range<size_t> const& range, Answers sum)
+            {
+                for (size_t i{range.begin()}; i < range.end(); ++i) {
+                    const auto [stops, clicks] {pieces[i].answers(entries[i])};
+                    sum.first += stops;
+                    sum.second += clicks;
+                }
+                return sum;
+            },
+            [](Answers a, Answers const& b) { return Answers{a.first + b.first, a.second + b.second}; });
 }
+
+
+// The original engine: the dial turned click by click.
+namespace reference {
+
+// Turns the dial click by click, returns how many clicks landed on zero.
+uint64_t turn(Dial& dial, int64_t rotation)
+{
+    const int sign{rotation < 0 ? -1 : 1};
+    const int64_t ptr{rotation * sign};
+
+    uint64_t zeros{0};
+
+    for (int64_t i{0}; i < ptr; ++i) {
+        dial.pos = dial.pos + (sign * 1);
+        if (dial.pos >= dial.size)
+            dial.pos -= dial.size;
+        if (dial.pos < 0)
+            dial.pos += dial.size;
+        if (dial.pos == 0)
+            ++zeros;
+    }
+
+    return zeros;
+}
+
+Aoc::Answer part1(Rotations const& rotations)
+{
+    Dial dial{Dial::configured()};
+    uint64_t zeros{0};
+
+    for (const int64_t r : rotations) {
+        turn(dial, r);
+        if (dial.pos == 0) {
+            ++zeros;
+        }
+    }
+
+    return zeros;
+}
+
+Aoc::Answer part2(Rotations const& rotations)
+{
+    Dial dial{Dial::configured()};
+    uint64_t zeros{0};
+
+    for (const int64_t r : rotations) {
+        zeros += turn(dial, r);
+    }
+
+    return zeros;
+}
+
+}  // namespace reference
+
+}  // namespace day1
+
+const Aoc::Register registered{1, day1::parse, day1::part1, day1::part2};
+const Aoc::RegisterStream<day1::Stream> streamed{1};
+const Aoc::RegisterScan scanned{1, day1::scan};
+const Aoc::RegisterReference reference{1, day1::reference::part1, day1::reference::part2};
@@ -1,8 +1,7 @@
-#include <fmt/core.h>
-#include <fmt/ranges.h>
-
-#include <boost/algorithm/string/classification.hpp>
-#include <boost/algorithm/string/split.hpp>
+#include "arena.h"
+#include "day.h"
+#include "input.h"
+#include "scope.h"
 
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/graph/depth_first_search.hpp>
@@ -12,11 +11,16 @@
 #include <deque>
 #include <fstream>
 #include <iostream>
+#include <map>
+#include <memory_resource>
 #include <ranges>
 #include <string>
+#include <string_view>
+
+namespace day11 {
 
-using StringVect = std::vector<std::string>;
-using Input = std::vector<StringVect>;
+using StringVect = std::pmr::vector<std::string_view>;
+using Input = std::pmr::vector<StringVect>;
 
 // Bundled vertex properties
 struct VProps
@@ -26,6 +30,8 @@ struct VProps
 
 using Graph = boost::adjacency_list<boost::vecS, boost::vecS, boost::directedS, VProps>;
 using Vertex = boost::graph_traits<Graph>::vertex_descriptor;
+using NodeMap = std::pmr::unordered_map<std::string_view, Vertex>;
+using VertexMap = std::pmr::map<Vertex, std::string_view>;
 
 namespace {
 
@@ -49,7 +55,7 @@ std::string dot_id(const std::string& name)
 }
 
 [[maybe_unused]]
-void dump_graph_to_dot(const Graph& g, const std::map<Vertex, std::string>& vertex2node, const std::string& filename)
+void dump_graph_to_dot(const Graph& g, VertexMap const& vertex2node, const std::string& filename)
 {
     std::ofstream out(filename);
     if (!out) {
@@ -63,7 +69,7 @@ void dump_graph_to_dot(const Graph& g, const std::map<Vertex, std::string>& vert
     {
         auto it = vertex2node.find(v);
         if (it != vertex2node.end())
-            return it->second;
+            return std::string{it->second};
 
         // Fallback to stable name if missing
         std::ostringstream oss;
@@ -120,9 +126,122 @@ enum class State : uint8_t {
     Done = 2
 };
 
+Graph make_graph(
+        Input const& input,
+        NodeMap& node2vertex,
+        VertexMap& vertex2node)
+{
+    Graph g;
+
+    for (auto const& v : input) {
+        for (auto const& s : v) {
+            if (node2vertex.contains(s))
+                continue;
+            Vertex vx{boost::add_vertex(g)};
+            node2vertex[s] = vx;
+            vertex2node[vx] = s;
+        }
+
+        Vertex const& from{node2vertex.at(v.at(0))};
+        for (auto const& s : v | std::views::drop(1)) {
+            boost::add_edge(from, node2vertex.at(s), g);
+        }
+    }
+
+    return g;
+}
+
+
+// The Boost graph keeps std::allocator, the name maps live in the run arena.
+struct Network
+{
+    explicit Network(std::pmr::memory_resource* r = Aoc::run_resource())
+        : node2vertex {r}
+        , vertex2node {r}
+    { }
+
+    Graph graph;
+    NodeMap node2vertex;
+    VertexMap vertex2node;
+};
+
+
+// Paths from start to dest, every vertex finished after its successors on
+// an explicit stack; the counts go to a scratch vector instead of a copy of
+// the graph.
+uint64_t count_paths(Graph const& g, Vertex start, Vertex dest)
+{
+    AOC_SCOPE("day11/count_paths");
+
+    using OutEdge = boost::graph_traits<Graph>::out_edge_iterator;
+
+    std::vector<uint64_t> paths(boost::num_vertices(g), 0);
+    std::vector<State> state(boost::num_vertices(g), State::Unknown);
+    std::vector<std::pair<Vertex, OutEdge>> stack;
+
+    auto enter = [&](Vertex u)
+    {
+        state[u] = State::InProgress;
+        stack.emplace_back(u, boost::out_edges(u, g).first);
+    };
+
+    paths[dest] = 1;  // exactly one path: dest -> dest (empty path)
+    state[dest] = State::Done;
+    if (state[start] == State::Unknown) {
+        enter(start);
+    }
+
+    while (!stack.empty()) {
+        auto& [u, it] {stack.back()};
+        if (it != boost::out_edges(u, g).second) {
+            const Vertex v{boost::target(*it++, g)};
+            if (state[v] == State::InProgress) {
+                throw std::runtime_error("Cycle detected on a reachable path: number of paths may be unbounded");
+            }
+            if (state[v] == State::Unknown) {
+                enter(v);
+            }
+            continue;
+        }
+
+        uint64_t total{0};
+        for (auto [eb, ee] {boost::out_edges(u, g)}; eb != ee; ++eb) {
+            total += paths[boost::target(*eb, g)];
+        }
+        paths[u] = total;
+        state[u] = State::Done;
+        stack.pop_back();
+    }
+
+    return paths[start];
+}
+
+
+Aoc::Answer part1(Network const& net)
+{
+    return count_paths(net.graph, net.node2vertex.at("you"), net.node2vertex.at("out"));
+}
+
+
+Aoc::Answer part2(Network const& net)
+{
+    auto const& node2vertex{net.node2vertex};
+
+    return count_paths(net.graph, node2vertex.at("svr"), node2vertex.at("fft"))
+         * count_paths(net.graph, node2vertex.at("fft"), node2vertex.at("dac"))
+         * count_paths(net.graph, node2vertex.at("dac"), node2vertex.at("out"));
+}
+
+
+// The original engine: a recursive DFS memoizing into the vertex properties
+// of a copy of the graph.
+namespace reference {
+
 // state: 0=unvisited, 1=visiting, 2=done
 int dfs_count_paths_to_dest(Graph& g, Vertex const u, Vertex const dest, std::vector<State>& state)
 {
+    AOC_SCOPE("day11/dfs_count_paths_to_dest");
+
     if (u == dest) {
         g[u].numPaths = 1;  // exactly one path: dest -> dest (empty path)
         return 1;
@@ -165,67 +284,59 @@ int32_t count_paths(Graph& g, Vertex start, Vertex dest)
 }
 
 
-Graph make_graph(
-        Input const& input,
-        std::unordered_map<std::string, Vertex>& node2vertex,
-        std::map<Vertex, std::string>& vertex2node)
+Aoc::Answer part1(Network const& net)
 {
-    Graph g;
-
-    for (auto const& v : input) {
-        for (auto const& s : v) {
-            if (node2vertex.contains(s))
-                continue;
-            Vertex vx{boost::add_vertex(g)};
-            node2vertex[s] = vx;
-            vertex2node[vx] = s;
-        }
-
-        Vertex const& from{node2vertex.at(v.at(0))};
-        for (auto const& s : v | std::views::drop(1)) {
-            boost::add_edge(from, node2vertex.at(s), g);
-        }
-    }
-
-    return g;
+    Graph g{net.graph};
+    return count_paths(g, net.node2vertex.at("you"), net.node2vertex.at("out"));
 }
 
 
-void process(Input const& input)
+Aoc::Answer part2(Network const& net)
 {
-    std::unordered_map<std::string, Vertex> node2vertex;
-    std::map<Vertex, std::string> vertex2node;
-
-    Graph g{make_graph(input, node2vertex, vertex2node)};
-
-    //  dump_graph_to_dot(g, vertex2node, "d11.dot");
-
-    fmt::print("1: {}\n", count_paths(g, node2vertex.at("you"), node2vertex.at("out")));
+    Graph g{net.graph};
+    auto const& node2vertex{net.node2vertex};
 
     auto const leg1{count_paths(g, node2vertex.at("svr"), node2vertex.at("fft"))};
     auto const leg2{count_paths(g, node2vertex.at("fft"), node2vertex.at("dac"))};
     auto const leg3{count_paths(g, node2vertex.at("dac"), node2vertex.at("out"))};
 
-    fmt::print("2: {}\n", (1ull * leg1 * leg2 * leg3));
+    return 1ull * leg1 * leg2 * leg3;
 }
 
+}  // namespace reference
 
-int main()
+
+Network parse(std::string_view data)
 {
-    Input input;
+    Input input{Aoc::run_resource()};
 
-    std::string line;
-    while (std::getline(std::cin, line)) {
+    for (std::string_view line : Aoc::Lines{data}) {
         if (line.empty()) {
             break;
         }
 
-        StringVect v;
-        boost::algorithm::split(v, line, boost::is_any_of(": "), boost::algorithm::token_compress_on);
+        StringVect v{Aoc::run_resource()};
+        for (auto const& token : line | std::views::split(' ')) {
+            std::string_view s{token.begin(), token.end()};
+            if (s.ends_with(':')) {
+                s.remove_suffix(1);
+            }
+            if (!s.empty()) {
+                v.push_back(s);
+            }
+        }
         input.push_back(std::move(v));
     }
 
-    process(input);
+    Network net;
+    net.graph = make_graph(input, net.node2vertex, net.vertex2node);
+
+    //  dump_graph_to_dot(net.graph, net.vertex2node, "d11.dot");
 
-    return 0;
+    return net;
 }
+
+}  // namespace day11
+
+const Aoc::Register registered{11, day11::parse, day11::part1, day11::part2};
+const Aoc::RegisterReference reference{11, day11::reference::part1, day11::reference::part2};
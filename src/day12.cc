@@ -1,17 +1,24 @@
-#include <fmt/core.h>
-#include <fmt/ranges.h>
+#include "arena.h"
+#include "day.h"
+#include "embedded.h"
+#include "input.h"
+#include "scanner.h"
 
-#include <boost/algorithm/string/classification.hpp>
-#include <boost/algorithm/string/split.hpp>
+#if AOC_EMBED
+#include "day12_input.h"
+#endif
 
 #include <algorithm>
+#include <array>
 #include <cassert>
-#include <deque>
-#include <iostream>
+#include <memory_resource>
 #include <ranges>
 #include <string>
+#include <string_view>
 #include <vector>
 
+namespace day12 {
+
 enum class ParseState {
     Start,
     ShapeHeader,
@@ -21,15 +28,24 @@ enum class ParseState {
 
 struct Area {
     unsigned dx{0}, dy{0};
-    std::vector<int> shapeCount;
+    std::array<int, 6> shapeCount{};
+};
+
+using Shapes = std::array<uint32_t, 6>;  // cells of each shape
+
+struct Input
+{
+    Shapes shapes{};
+    Aoc::Table<Area> areas;
 };
 
 
-void part1(std::vector<uint32_t> const& shapes, std::vector<Area> const& areas)
+Aoc::Answer part1(Input const& input)
 {
     unsigned passed{0};
 
-    for (auto const& a : areas) {
+    auto const& shapes{input.shapes};
+    for (auto const& a : input.areas) {
         uint32_t shapeArea{0};
         for (auto const& [shapeSize, shapeCount] : std::views::zip(shapes, a.shapeCount)) {
             if (shapeCount) {
@@ -42,27 +58,25 @@ void part1(std::vector<uint32_t> const& shapes, std::vector<Area> const& areas)
         }
     }
 
-    fmt::print("1: {}\n", passed);
+    return passed;
 }
 
 
-int main()
+// Calls on_shape(id, size) for each shape, then on_area(area) for each area.
+template<typename OnShape, typename OnArea>
+constexpr void scan(std::string_view data, OnShape&& on_shape, OnArea&& on_area)
 {
-    std::vector<uint32_t> shapes(6, 0);
-    std::vector<Area> areas;
-
     auto state {ParseState::Start};
     int shapeId{-1};
     uint32_t shapeSize{0};
 
-    std::string line;
-    while (std::getline(std::cin, line)) {
+    for (std::string_view line : Aoc::Lines{data}) {
         if (line.empty()) {
             if (state == ParseState::Area) {
                 break;
             }
             else if (state == ParseState::ShapeHeader) {
-                shapes.at(shapeId) = shapeSize;
+                on_shape(shapeId, shapeSize);
                 shapeSize = 0;
                 shapeId = -1;
                 state = ParseState::Start;
@@ -76,31 +90,88 @@ int main()
                 continue;
             }
             else if (state == ParseState::Start && !line.contains('x')) {
-                shapeId = std::atoi(&line[0]);
+                shapeId = Aoc::to_int<int>(line);
                 state = ParseState::ShapeHeader;
                 continue;
             }
 
             state = ParseState::Area;
 
-            // expecting NxN or newline
-            std::deque<std::string> parts;
-            boost::algorithm::split(parts, line, boost::is_any_of("x: "), boost::algorithm::token_compress_on);
-            assert(parts.size() == 8);
+            // expecting NxN: counts
+            std::array<int, 8> parts{};
+            [[maybe_unused]] const auto count{Aoc::parse_list(line, std::span{parts})};
+            assert(count == 8);
 
             Area a;
-            a.dx = std::stoi(parts.front());
-            parts.pop_front();
-            a.dy = std::stoi(parts.front());
-            parts.pop_front();
-            for (auto const& s : parts) {
-                a.shapeCount.push_back(std::stoi(s));
-            }
-            areas.push_back(std::move(a));
+            a.dx = parts[0];
+            a.dy = parts[1];
+            std::ranges::copy(parts | std::views::drop(2), a.shapeCount.begin());
+            on_area(a);
         }
     }
+}
+
+
+Input parse(std::string_view data)
+{
+    Shapes shapes{};
+    std::pmr::vector<Area> areas{Aoc::run_resource()};
+
+    scan(
+            data,
+            [&](int id, uint32_t size) { shapes.at(id) = size; },
+            [&](Area const& a) { areas.push_back(a); });
+
+    return {.shapes = shapes, .areas = std::move(areas)};
+}
+
+
+#if AOC_EMBED
 
-    part1(shapes, areas);
+namespace embedded {
 
-    return 0;
+constexpr size_t count(std::string_view data)
+{
+    size_t n{0};
+    scan(data, [](int, uint32_t) {}, [&](Area const&) { ++n; });
+    return n;
+}
+
+template<size_t N>
+struct Parsed
+{
+    Shapes shapes{};
+    std::array<Area, N> areas{};
+};
+
+template<size_t N>
+constexpr Parsed<N> parse(std::string_view data)
+{
+    Parsed<N> p;
+    size_t i{0};
+    scan(
+            data,
+            [&](int id, uint32_t size) { p.shapes.at(id) = size; },
+            [&](Area const& a) { p.areas[i++] = a; });
+    return p;
+}
+
+constinit const auto parsed{parse<count(Aoc::Embedded::day12)>(Aoc::Embedded::day12)};
+
+}  // namespace embedded
+
+
+Input builtin()
+{
+    return {.shapes = embedded::parsed.shapes, .areas = embedded::parsed.areas};
 }
+
+#endif
+
+}  // namespace day12
+
+#if AOC_EMBED
+const Aoc::Register registered{12, day12::parse, day12::part1, nullptr, day12::builtin};
+#else
+const Aoc::Register registered{12, day12::parse, day12::part1};
+#endif
@@ -1,53 +1,337 @@
+#include "day.h"
+#include "input.h"
+#include "interval.h"
+#include "scanner.h"
+
 #include <fmt/core.h>
 
-#include <boost/algorithm/string/classification.hpp>
-#include <boost/algorithm/string/split.hpp>
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_reduce.h>
 
+#include <algorithm>
+#include <array>
 #include <cassert>
-#include <deque>
-#include <iostream>
+#include <cstdlib>
+#include <functional>
 #include <set>
 #include <string>
 #include <string_view>
 #include <vector>
 
+namespace day2 {
+
 using Value = uint64_t;
-using Values = std::vector<std::pair<Value, Value>>;
+using Values = std::vector<Aoc::Interval<Value>>;
+
+
+// Sums of IDs can pass 64 bits before the final answer.
+using Wide = unsigned __int128;
+
+// IDs have at most 20 digits
+constexpr unsigned max_digits{20};
+
+constexpr auto pow10{[]
+{
+    std::array<Wide, max_digits + 1> p{1};
+    for (size_t i{1}; i < p.size(); ++i) {
+        p[i] = p[i - 1] * 10;
+    }
+    return p;
+}()};
+
+constexpr unsigned digits(Value v)
+{
+    unsigned d{1};
+    while (d < max_digits && v >= pow10[d]) {
+        ++d;
+    }
+    return d;
+}
+
+
+constexpr int mobius(unsigned n)
+{
+    int mu{1};
+    for (unsigned p{2}; p <= n; ++p) {
+        if (n % p == 0) {
+            n /= p;
+            if (n % p == 0) {
+                return 0;
+            }
+            mu = -mu;
+        }
+    }
+    return mu;
+}
+
+
+// Part of a range whose IDs all have d digits.
+struct Shard
+{
+    Value lo{0}, hi{0};
+    unsigned d{0};
+};
+
+struct Input
+{
+    Values ranges;  // sorted and disjoint
+    std::vector<Shard> shards;  // the ranges cut at powers of ten
+};
+
+
+Input parse(std::string_view data)
+{
+    Values values;
+
+    Aoc::Scanner scan{*Aoc::Lines{data}.begin()};
+    Value v1{0}, v2{0};
+    while (scan.next(v1) && scan.next(v2)) {
+        values.push_back({v1, v2});
+    }
+
+    // joined where they overlap, so no ID is counted twice
+    values.resize(Aoc::merge(values));
+
+    Input input{.ranges = std::move(values)};
+    for (auto const& [from, to] : input.ranges) {
+        for (unsigned d{digits(from)}; d <= digits(to); ++d) {
+            input.shards.push_back({.lo = std::max<Value>(from, pow10[d - 1]),
+                                    .hi = d < max_digits ? std::min<Value>(to, pow10[d] - 1) : to,
+                                    .d = d});
+        }
+    }
+    return input;
+}
+
+
+// An ID of d digits repeating a block of k digits is block * mult with
+// mult = 10^(d - k) + ... + 10^k + 1. It also repeats a block of j digits
+// for every j dividing k, so by Moebius inversion the IDs whose shortest
+// block has j digits are the sum over k | j of mobius(j / k) times those
+// repeating k digits. Summing that over the proper divisors j of d, which
+// part2 wants, leaves one weight per block length k.
+struct Block
+{
+    unsigned k{0};
+    int weight{0};
+    Wide mult{0};
+};
+
+struct Length
+{
+    std::array<Block, max_digits> blocks{};
+    unsigned count{0};
+    unsigned half{0};  // index of k = d / 2, for even d
+};
+
+// Everything that only depends on the digit count, at compile time.
+constexpr auto lengths{[]
+{
+    std::array<Length, max_digits + 1> all{};
+    for (unsigned d{2}; d <= max_digits; ++d) {
+        auto& length{all[d]};
+        for (unsigned k{1}; k < d; ++k) {
+            if (d % k) {
+                continue;
+            }
+            int weight{0};
+            for (unsigned j{k}; j < d; j += k) {
+                if (d % j == 0) {
+                    weight += mobius(j / k);
+                }
+            }
+            if (2 * k == d) {
+                length.half = length.count;
+            }
+            length.blocks[length.count++] = {.k = k, .weight = weight, .mult = (pow10[d] - 1) / (pow10[k] - 1)};
+        }
+    }
+    return all;
+}()};
+
+
+// Sum of block * mult over the blocks of k digits for which it lies in
+// [low, high]: those blocks form one interval, so an arithmetic series.
+template<typename T>
+constexpr Wide repeated_sum(T low, T high, T mult, unsigned k)
+{
+    const T first{std::max<T>((low + mult - 1) / mult, pow10[k - 1])};
+    const T last{std::min<T>(high / mult, pow10[k] - 1)};
+    if (first > last) {
+        return 0;
+    }
+    return Wide{mult} * ((first + last) * (last - first + 1) / 2);
+}
+
+// The same for the IDs of a shard. Below 20 digits the IDs, the multipliers
+// and the block sums all fit 64 bits, which divide much faster than 128.
+constexpr Wide repeated_sum(Shard const& shard, Block const& block)
+{
+    if (shard.d < max_digits) {
+        return repeated_sum<Value>(shard.lo, shard.hi, static_cast<Value>(block.mult), block.k);
+    }
+    return repeated_sum<Wide>(shard.lo, shard.hi, block.mult, block.k);
+}
+
+
+constexpr __int128 part1_sum(Shard const& shard)
+{
+    if (shard.d % 2) {
+        return 0;
+    }
+    auto const& length{lengths[shard.d]};
+    return repeated_sum(shard, length.blocks[length.half]);
+}
+
+constexpr __int128 part2_sum(Shard const& shard)
+{
+    __int128 sum{0};
+    auto const& length{lengths[shard.d]};
+    for (unsigned i{0}; i < length.count; ++i) {
+        if (auto const& block{length.blocks[i]}; block.weight) {
+            sum += block.weight * static_cast<__int128>(repeated_sum(shard, block));
+        }
+    }
+    return sum;
+}
+
+
+// Every shard costs the same few series, so a few thousand of them make a
+// task worth its scheduling. The sums are exact and the deterministic
+// reduce splits and joins the same way on every run.
+constexpr size_t shard_grain{4096};
+
+template<typename Sum>
+Aoc::Answer sum_shards(std::vector<Shard> const& shards, Sum&& sum)
+{
+    return static_cast<Aoc::Answer>(tbb::parallel_deterministic_reduce(
+            tbb::blocked_range<size_t>{0, shards.size(), shard_grain},
+            __int128{0},
+            [&](tbb::blocked_range<size_t> const& range, __int128 total)
+            {
+                for (size_t i{range.begin()}; i < range.end(); ++i) {
+                    total += sum(shards[i]);
+                }
+                return total;
+            },
+            std::plus<>{}));
+}
+
+
+// AOC_DAY2_VERBOSE=1 lists the invalid IDs of every range on stderr, in a
+// pass of its own, so the sums never look at it.
+bool verbose()
+{
+    static const bool on{[]
+    {
+        const char* env{std::getenv("AOC_DAY2_VERBOSE")};
+        return env && *env && std::string_view{env} != "0";
+    }()};
+    return on;
+}
+
+// Repeated-digit IDs of a shard, ascending; with only_half just those
+// repeating their half.
+std::vector<Value> invalid_ids(Shard const& shard, bool only_half)
+{
+    std::vector<Value> ids;
+    auto const& length{lengths[shard.d]};
+    for (unsigned i{0}; i < length.count; ++i) {
+        auto const& block{length.blocks[i]};
+        if (only_half && i != length.half) {
+            continue;
+        }
+        const Wide first{std::max<Wide>((shard.lo + block.mult - 1) / block.mult, pow10[block.k - 1])};
+        const Wide last{std::min<Wide>(shard.hi / block.mult, pow10[block.k] - 1)};
+        for (Wide b{first}; b <= last; ++b) {
+            ids.push_back(static_cast<Value>(b * block.mult));
+        }
+    }
+    std::ranges::sort(ids);
+    ids.erase(std::ranges::unique(ids).begin(), ids.end());
+    return ids;
+}
+
+void list(Input const& input, int part)
+{
+    auto shard{input.shards.begin()};
+    for (auto const& [v1, v2] : input.ranges) {
+        fmt::print(stderr, "part {} {}-{}:", part, v1, v2);
+        for (; shard != input.shards.end() && shard->hi <= v2; ++shard) {
+            if (part == 2 || shard->d % 2 == 0) {
+                for (const Value id : invalid_ids(*shard, part == 1)) {
+                    fmt::print(stderr, " {}", id);
+                }
+            }
+        }
+        fmt::print(stderr, "\n");
+    }
+}
+
 
-void part1(Values const& values)
+Aoc::Answer part1(Input const& input)
+{
+    if (verbose()) {
+        list(input, 1);
+    }
+    return sum_shards(input.shards, part1_sum);
+}
+
+
+Aoc::Answer part2(Input const& input)
+{
+    if (verbose()) {
+        list(input, 2);
+    }
+    return sum_shards(input.shards, part2_sum);
+}
+
+
+// The original engine: every ID formatted and its halves or blocks compared.
+namespace reference {
+
+Aoc::Answer part1(Input const& input)
 {
     Value sum{0};
 
-    for (auto const& [v1, v2] : values) {
-        for (Value i{v1}; i <= v2; ++i) {
+    for (auto const& [v1, v2] : input.ranges) {
+        if (v1 > v2) {
+            continue;
+        }
+        // v2 may be the largest Value, i <= v2 would never fail
+        for (Value i{v1};; ++i) {
             const std::string s{std::to_string(i)};
-            if (s.size() & 0x1)
-                continue; // only even size
-
-            bool invalid{true};
-            for (size_t p1{0}, p2{s.size() / 2u}; p2 < s.size(); ++p1, ++p2) {
-                if (s.at(p1) != s.at(p2)) {
-                    invalid = false;
-                    break;
+            if ((s.size() & 0x1) == 0) { // only even size
+                bool invalid{true};
+                for (size_t p1{0}, p2{s.size() / 2u}; p2 < s.size(); ++p1, ++p2) {
+                    if (s.at(p1) != s.at(p2)) {
+                        invalid = false;
+                        break;
+                    }
+                }
+                if (invalid) {
+                    sum += i;
                 }
             }
-            if (invalid) {
-                sum += i;
-                fmt::print("({}-{}) - {}\n", v1, v2, i);
+            if (i == v2) {
+                break;
             }
         }
     }
 
-    fmt::print("1: {}\n", sum);
+    return sum;
 }
 
 
-void part2(Values const& values)
+Aoc::Answer part2(Input const& input)
 {
     Value sum{0};
 
-    for (auto const& [v1, v2] : values) {
-        for (Value i{v1}; i <= v2; ++i) {
+    for (auto const& [v1, v2] : input.ranges) {
+        if (v1 > v2) {
+            continue;
+        }
+        for (Value i{v1};; ++i) {
             const std::string s{std::to_string(i)};
             std::string_view sv(s);
 
@@ -68,37 +352,18 @@ void part2(Values const& values)
                     break;
                 }
             }
+            if (i == v2) {
+                break;
+            }
         }
     }
 
-    fmt::print("2: {}\n", sum);
+    return sum;
 }
 
-int main()
-{
-    std::string line;
-    std::getline(std::cin, line);
-
-    if (line.empty())
-        return 1;
-
-    Values values;
+}  // namespace reference
 
-    std::deque<std::string> items;
-    boost::algorithm::split(items, line, boost::is_any_of(", -"), boost::algorithm::token_compress_on);
+}  // namespace day2
 
-    while(!items.empty()) {
-        Value v1{std::stoull(items.front())};
-        items.pop_front();
-
-        Value v2{std::stoull(items.front())};
-        items.pop_front();
-
-        values.push_back({v1, v2});
-    }
-
-    part1(values);
-    part2(values);
-
-    return 0;
-}
+const Aoc::Register registered{2, day2::parse, day2::part1, day2::part2};
+const Aoc::RegisterReference reference{2, day2::reference::part1, day2::reference::part2};
@@ -1,67 +1,61 @@
-#include <fmt/core.h>
+#include "day.h"
+#include "simd.h"
 
 #include <algorithm>
 #include <cassert>
-#include <deque>
-#include <iostream>
-#include <ranges>
-#include <string>
+#include <string_view>
 #include <vector>
 
-using Strings = std::vector<std::string>;
+namespace day3 {
 
-uint64_t extractNumbers(std::string_view s, unsigned digits)
+using Strings = std::vector<std::string_view>;
+
+Strings parse(std::string_view data)
 {
-    std::deque<char> result;
+    Strings input;
 
-    size_t from{0};
-    for (unsigned d{1}; d <= digits; ++d) {
+    while (!data.empty()) {
+        const size_t eol{Aoc::Simd::find_newline(data)};
+        if (eol == 0) {
+            break;
+        }
+        input.push_back(data.substr(0, eol));
+        data.remove_prefix(std::min(eol + 1, data.size()));
+    }
 
-        const auto top{std::ranges::max_element(s.substr(from, s.size() - from - (digits - d)))};
-        assert(top != s.cend());
+    return input;
+}
 
-        result.push_back(*top);
-        from = std::distance(s.cbegin(), top) + 1;
-    }
+// Largest number made of digits characters of s in their order: each digit
+// is the first maximum of what is left, keeping enough for the rest.
+uint64_t extractNumbers(std::string_view s, unsigned digits)
+{
+    assert(digits <= 19 && digits <= s.size());
+    char result[19];
 
-    uint64_t sum{0};
-    for (const auto& [idx, c] : result | std::views::reverse | std::views::enumerate) {
-        sum += (c - '0') * std::pow(10, idx);
+    size_t from{0};
+    for (unsigned d{0}; d < digits; ++d) {
+        const auto top{Aoc::Simd::max_digit(s.substr(from, s.size() - from - (digits - 1 - d)))};
+        result[d] = top.digit;
+        from += top.pos + 1;
     }
 
-    return sum;
+    return Aoc::Simd::digits({result, digits});
 }
 
 
-void part1(Strings const& input)
+Aoc::Answer part1(Strings const& input)
 {
     uint64_t sum{0};
 
     for (auto const& line : input) {
-        char c1{0}, c2{0};
-        size_t pos1{0};
-
-        std::string_view v{line};
-
-        for (auto const& [idx, c] : std::views::enumerate(v.substr(0, v.size() - 1))) {
-            if (c > c1) {
-                c1 = c;
-                pos1 = idx;
-            }
-        }
-
-        for (auto const& c : v.substr(pos1+1)) {
-            c2 = std::max(c2, c);
-        }
-
-        auto x{((c1 - '0') * 10) + (c2 - '0')};
-        sum += x;
+        sum += extractNumbers(line, 2);
     }
 
-    fmt::print("1: {}\n", sum);
+    return sum;
 }
 
-void part2(Strings const& input)
+Aoc::Answer part2(Strings const& input)
 {
     uint64_t sum{0};
 
@@ -70,23 +64,30 @@ void part2(Strings const& input)
         sum += v;
     }
 
-    fmt::print("2: {}\n", sum);
+    return sum;
 }
 
-int main()
+
+class Stream : public Aoc::LineSolver
 {
-    Strings input;
+    uint64_t sum1{0}, sum2{0};
 
-    std::string line;
-    while(std::getline(std::cin, line)) {
+public:
+    bool line(std::string_view line) override
+    {
         if (line.empty()) {
-            break;
+            return false;
         }
-        input.push_back(std::move(line));
+        sum1 += extractNumbers(line, 2);
+        sum2 += extractNumbers(line, 12);
+        return true;
     }
 
-    part1(input);
-    part2(input);
+    Aoc::Answer part1() const override { return sum1; }
+    Aoc::Answer part2() const override { return sum2; }
+};
 
-    return 0;
-}
+}  // namespace day3
+
+const Aoc::Register registered{3, day3::parse, day3::part1, day3::part2};
+const Aoc::RegisterStream<day3::Stream> streamed{3};
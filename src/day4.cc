@@ -1,104 +1,109 @@
+#include "day.h"
 #include "point2d.h"
 
-#include <fmt/core.h>
-#include <fmt/ranges.h>
+#include <array>
+#include <cstddef>
+#include <ranges>
+#include <span>
+#include <string_view>
+#include <vector>
 
-#include <iostream>
-#include <unordered_set>
+namespace day4 {
 
 using Coord = int32_t;
 using Point = Gfx_2d::Point<Coord>;
 
-using Map = std::unordered_set<Point, boost::hash<Point>>;
+using Map = Gfx_2d::Grid<uint8_t>;  // 1 for a roll of paper, one empty cell of border
 
+using Offsets = std::array<ptrdiff_t, 8>;
 
-void part1(Map const& world)
+Offsets neighbour_offsets(Map const& world)
 {
+    Offsets offsets;
+    for (auto&& [off, dir] : std::views::zip(
+                 offsets,
+                 std::array{
+                         Gfx_2d::North,
+                         Gfx_2d::South,
+                         Gfx_2d::West,
+                         Gfx_2d::East,
+                         Gfx_2d::NW,
+                         Gfx_2d::NE,
+                         Gfx_2d::SW,
+                         Gfx_2d::SE}))
+    {
+        off = world.offset(dir);
+    }
+    return offsets;
+}
+
+
+unsigned rolls_around(std::span<const uint8_t> cells, size_t idx, Offsets const& offsets)
+{
+    unsigned around{0};
+    for (auto off : offsets) {
+        around += cells[idx + off];
+    }
+    return around;
+}
+
+
+Map parse(std::string_view data)
+{
+    return Map::from_text(data, [](char c) -> uint8_t { return c == '@'; }, 1);
+}
+
+
+Aoc::Answer part1(Map const& world)
+{
+    const auto offsets{neighbour_offsets(world)};
+    const auto cells{world.cells()};
+
     unsigned movable{0};
 
-    for (auto const& px : world) {
-        unsigned around{0};
-        for (auto const& dir :
-             {Gfx_2d::North, Gfx_2d::South, Gfx_2d::West, Gfx_2d::East, Gfx_2d::NW, Gfx_2d::NE, Gfx_2d::SW, Gfx_2d::SE})
-        {
-            if (world.contains(px + dir)) {
-                ++around;
+    for (Coord y{0}; y < world.height(); ++y) {
+        for (size_t idx{world.index(Point{0, y})}, end{idx + world.width()}; idx < end; ++idx) {
+            if (cells[idx] && rolls_around(cells, idx, offsets) < 4) {
+                ++movable;
             }
         }
-
-        if (around < 4) {
-            ++movable;
-        }
     }
 
-    fmt::print("1: {}\n", movable);
+    return movable;
 }
 
 
-void part2(Map world)
+Aoc::Answer part2(Map const& input)
 {
+    Map world{input};
+    const auto offsets{neighbour_offsets(world)};
+    const auto cells{world.cells()};
+
     unsigned removable{0};
+    std::vector<size_t> candidates;
 
     for (;;) {
-        Map candidates;
-
-        for (auto const& px : world) {
-            unsigned around{0};
-            for (auto const& dir :
-                 {Gfx_2d::North,
-                  Gfx_2d::South,
-                  Gfx_2d::West,
-                  Gfx_2d::East,
-                  Gfx_2d::NW,
-                  Gfx_2d::NE,
-                  Gfx_2d::SW,
-                  Gfx_2d::SE})
-            {
-                if (world.contains(px + dir)) {
-                    ++around;
+        for (Coord y{0}; y < world.height(); ++y) {
+            for (size_t idx{world.index(Point{0, y})}, end{idx + world.width()}; idx < end; ++idx) {
+                if (cells[idx] && rolls_around(cells, idx, offsets) < 4) {
+                    candidates.push_back(idx);
                 }
             }
-
-            if (around < 4) {
-                ++removable;
-                candidates.insert(px);
-            }
         }
 
         if (candidates.empty())
             break;
 
-        for (auto const& px : candidates) {
-            world.erase(px);
+        removable += candidates.size();
+        for (auto idx : candidates) {
+            cells[idx] = 0;
         }
         candidates.clear();
     }
 
-    fmt::print("2: {}\n", removable);
+    return removable;
 }
 
-int main()
-{
-    Map world;
+}  // namespace day4
 
-    {
-        std::string line;
-        for (Coord y{0}; std::getline(std::cin, line); ++y) {
-            if (line.empty())
-                break;
-
-            Coord x{0};
-            for (auto const& c : line) {
-                if (c == '@') {
-                    world.insert({x, y});
-                }
-                ++x;
-            }
-        }
-    }
-
-    part1(world);
-    part2(world);
-
-    return 0;
-}
+const Aoc::Register registered{4, day4::parse, day4::part1, day4::part2};
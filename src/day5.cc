@@ -1,68 +1,226 @@
-#include <fmt/core.h>
+#include "arena.h"
+#include "day.h"
+#include "embedded.h"
+#include "input.h"
+#include "interval.h"
+#include "scanner.h"
 
-#include <boost/icl/interval.hpp>
-#include <boost/icl/interval_set.hpp>
+#if AOC_EMBED
+#include "day5_input.h"
+#endif
 
 #include <algorithm>
-#include <cassert>
-#include <iostream>
-#include <string>
+#include <array>
+#include <iterator>
+#include <limits>
+#include <memory_resource>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
 #include <vector>
 
+namespace day5 {
+
 using Val = uint64_t;
 
-struct Recipes
+using Range = Aoc::Interval<Val>;
+
+
+// How many IDs the disjoint ranges hold: 2^64 when they cover every ID,
+// which no Answer can hold.
+Val fresh_ids(std::span<Range const> ranges)
 {
-    using Interval = boost::icl::interval<Val>;
-    using ISet = boost::icl::interval_set<Val>;
+    unsigned __int128 total{0};
+    for (auto const& r : ranges) {
+        total += static_cast<unsigned __int128>(r.to - r.from) + 1;
+    }
+    if (total > std::numeric_limits<Val>::max()) {
+        throw std::overflow_error("Every ID is fresh, 2^64 does not fit the answer");
+    }
+    return static_cast<Val>(total);
+}
 
-    ISet recipes;
 
-    bool contains(Val v) const
-    {
-        return recipes.find(v) != recipes.end();
+// Calls on_range(from, to) for the first section, on_id(id) for the second.
+template<typename OnRange, typename OnId>
+constexpr void scan(std::string_view data, OnRange&& on_range, OnId&& on_id)
+{
+    auto section{Aoc::Records{data}.begin()};
+
+    for (std::string_view line : Aoc::Lines{*section}) {
+        Aoc::Scanner scan{line};
+        Val from{0}, to{0};
+        scan.next(from);
+        scan.next(to);
+        on_range(from, to);
     }
 
-    Val all_values() const
-    {
-        Val total{0};
-        for (auto const& i : recipes) {
-            total += i.upper() - i.lower() + 1;
-        }
-        return total;
+    if (++section == std::default_sentinel) {
+        return;  // ranges only
+    }
+    for (std::string_view line : Aoc::Lines{*section}) {
+        on_id(Aoc::to_int<Val>(line));
     }
+}
+
 
-    void add(Val from, Val to) { recipes += Interval::closed(from, to); }
+struct Input
+{
+    Aoc::Table<Range> fresh;  // sorted and disjoint
+    Aoc::Table<Val> ingredients;
 };
 
-int main()
+
+Input parse(std::string_view data)
 {
-    Recipes recipes;
+    std::pmr::vector<Range> fresh{Aoc::run_resource()};
+    std::pmr::vector<Val> ingredients{Aoc::run_resource()};
 
-    std::string line;
-    while (std::getline(std::cin, line)) {
-        if (line.empty())
-            break;
+    scan(
+            data,
+            [&](Val from, Val to) { fresh.push_back({from, to}); },
+            [&](Val id) { ingredients.push_back(id); });
 
-        const auto sep{line.find('-')};
-        line.at(sep) = '\0';
-        recipes.add(std::stoull(&line[0]), std::stoull(&line[sep + 1]));
-    }
+    fresh.resize(Aoc::merge(fresh));
+    return {.fresh = std::move(fresh), .ingredients = std::move(ingredients)};
+}
 
-    Val cnt1{0};
 
-    while (std::getline(std::cin, line)) {
-        if (line.empty())
-            break;
+#if AOC_EMBED
+
+namespace embedded {
+
+constexpr std::pair<size_t, size_t> count(std::string_view data)
+{
+    std::pair<size_t, size_t> n{0, 0};
+    scan(data, [&](Val, Val) { ++n.first; }, [&](Val) { ++n.second; });
+    return n;
+}
+
+template<size_t Ranges, size_t Ids>
+struct Parsed
+{
+    std::array<Range, Ranges> fresh{};  // merged ones first
+    size_t merged{0};
+    std::array<Val, Ids> ingredients{};
+};
+
+template<size_t Ranges, size_t Ids>
+constexpr Parsed<Ranges, Ids> parse(std::string_view data)
+{
+    Parsed<Ranges, Ids> p;
+    size_t r{0}, i{0};
+    scan(
+            data,
+            [&](Val from, Val to) { p.fresh[r++] = {from, to}; },
+            [&](Val id) { p.ingredients[i++] = id; });
+    p.merged = Aoc::merge(p.fresh);
+    return p;
+}
+
+constexpr auto sizes{count(Aoc::Embedded::day5)};
+constexpr auto parsed{parse<sizes.first, sizes.second>(Aoc::Embedded::day5)};
+
+constinit const auto fresh{Aoc::take<parsed.merged>(parsed.fresh)};
+constinit const auto ingredients{parsed.ingredients};
 
-        const Val v{std::stoull(&line[0])};
-        if (recipes.contains(v)) {
+}  // namespace embedded
+
+
+Input builtin()
+{
+    return {.fresh = embedded::fresh, .ingredients = embedded::ingredients};
+}
+
+#endif
+
+
+Aoc::Answer part1(Input const& input)
+{
+    const auto fresh{input.fresh.span()};
+
+    Val cnt1{0};
+    for (const Val v : input.ingredients) {
+        // last range starting at or before v
+        auto it{std::ranges::upper_bound(fresh, v, {}, &Range::from)};
+        if (it != fresh.begin() && v <= std::prev(it)->to) {
             ++cnt1;
         }
     }
 
-    fmt::print("1: {}\n", cnt1);
-    fmt::print("2: {}\n", recipes.all_values());
+    return cnt1;
+}
 
-    return 0;
+Aoc::Answer part2(Input const& input)
+{
+    return fresh_ids(input.fresh.span());
 }
+
+
+// Keeps only the ranges: they are merged at the blank line that ends their
+// section, and the ids are checked as they arrive. Without that line part2
+// merges a copy of the ranges read so far.
+class Stream : public Aoc::LineSolver
+{
+    enum class Section
+    {
+        Ranges,
+        Ids
+    };
+
+    Section section{Section::Ranges};
+    std::vector<Range> fresh;
+    Val total{0};
+    Val ids{0}, count{0};
+
+public:
+    bool line(std::string_view line) override
+    {
+        if (section == Section::Ranges) {
+            if (!line.empty()) {
+                Aoc::Scanner scan{line};
+                Range r;
+                scan.next(r.from);
+                scan.next(r.to);
+                fresh.push_back(r);
+            }
+            else if (!fresh.empty()) {
+                fresh.resize(Aoc::merge(fresh));
+                total = fresh_ids(fresh);
+                section = Section::Ids;
+            }
+            return true;
+        }
+
+        if (line.empty()) {
+            return ids == 0;  // blank lines before the first id
+        }
+        ++ids;
+        const Val v{Aoc::to_int<Val>(line)};
+        auto it{std::ranges::upper_bound(fresh, v, {}, &Range::from)};
+        count += it != fresh.begin() && v <= std::prev(it)->to;
+        return true;
+    }
+
+    Aoc::Answer part1() const override { return count; }
+    Aoc::Answer part2() const override
+    {
+        if (section == Section::Ranges) {
+            // no blank line (yet), the ranges so far
+            std::vector<Range> merged{fresh};
+            merged.resize(Aoc::merge(merged));
+            return fresh_ids(merged);
+        }
+        return total;
+    }
+};
+
+}  // namespace day5
+
+#if AOC_EMBED
+const Aoc::Register registered{5, day5::parse, day5::part1, day5::part2, day5::builtin};
+#else
+const Aoc::Register registered{5, day5::parse, day5::part1, day5::part2};
+#endif
+const Aoc::RegisterStream<day5::Stream> streamed{5};
@@ -1,24 +1,70 @@
-#include <fmt/core.h>
-#include <fmt/ranges.h>
-
-#include <boost/algorithm/string/classification.hpp>
-#include <boost/algorithm/string/split.hpp>
-#include <boost/algorithm/string/trim.hpp>
+#include "day.h"
+#include "input.h"
+#include "scanner.h"
+#include "simd.h"
 
+#include <algorithm>
 #include <cassert>
 #include <functional>
-#include <iostream>
 #include <numeric>
 #include <ranges>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
+namespace day6 {
+
 using Row = std::vector<uint64_t>;
 using Rows = std::vector<Row>;
-using StringVect = std::vector<std::string>;
+using StringVect = std::vector<std::string_view>;
 
-void part1(Rows const& values, StringVect const& ops)
+struct Input
 {
+    Rows values;
+    StringVect ops;
+    StringVect lines;
+};
+
+Input parse(std::string_view data)
+{
+    Input input;
+
+    for (std::string_view line : Aoc::Lines{data}) {
+        if (line.empty()) {
+            break;
+        }
+
+        input.lines.push_back(line);
+
+        const auto first{line.find_first_not_of(' ')};
+        if (first != std::string_view::npos && (line[first] == '+' || line[first] == '*')) {
+            for (auto const& [idx, c] : std::views::enumerate(line)) {
+                if (c != ' ') {
+                    input.ops.push_back(line.substr(idx, 1));
+                }
+            }
+            break;
+        }
+
+        Row r;
+        Aoc::Scanner scan{line};
+        for (uint64_t num{0}; scan.next(num);) {
+            r.push_back(num);
+        }
+        input.values.push_back(std::move(r));
+    }
+
+    assert(input.ops.size() == input.values.at(0).size());
+
+    return input;
+}
+
+Aoc::Answer part1(Input const& in)
+{
+    Rows const& values{in.values};
+    StringVect const& ops{in.ops};
+
     uint64_t sum{0};
 
     for (auto const& [idx, op] : ops | std::views::enumerate) {
@@ -44,95 +90,77 @@ void part1(Rows const& values, StringVect const& ops)
         }
     }
 
-    fmt::print("1: {}\n", sum);
+    return sum;
 }
 
 
-void part2(StringVect input)
+// The digit rows as one grid of equal lines stride bytes apart: the input
+// itself when its lines are evenly spaced, else a copy padded with spaces.
+struct Grid
 {
-    std::ranges::reverse(input);
-    for (auto& line : input) {
-        std::ranges::reverse(line);
-    }
-
-    uint64_t sum{0};
-    Row r;
-
-    for (size_t pos{0}; pos < input.at(0).size(); ++pos) {
-        int exp{0};
-        char op{0};
-        uint64_t val{0};
-
-        for (auto const& line : input) {
-            char c{line.at(pos)};
-            if (c == ' ') {
-                continue;
-            } else if (c == '+') {
-                op = '+';
-                continue;
-            } else if (c == '*') {
-                op = '*';
-                continue;
-            }
-            assert(c >= '0');
-            assert(c <= '9');
-
-            c -= '0';
-            val += c * std::pow(10, exp++);
-        }
-
-        r.push_back(val);
-
-        if (op) {
-            if (op == '+') {
-                sum += std::ranges::fold_left(r, 0, std::plus{});
-            } else {
-                if (std::ranges::find(r, 0) == r.cend()) {
-                    sum += std::ranges::fold_left(r, 1, std::multiplies{});
+    const char* data{nullptr};
+    size_t stride{0};
+    std::string copy;
+
+    Grid(std::span<std::string_view const> lines, size_t width)
+    {
+        data = lines[0].data();
+        stride = lines.size() > 1 ? lines[1].data() - lines[0].data() : width;
+        for (auto const& [idx, line] : lines | std::views::enumerate) {
+            if (line.size() != width || line.data() != data + idx * stride) {
+                stride = width;
+                for (auto const& l : lines) {
+                    copy.append(l.substr(0, width));
+                    copy.append(width - std::min(width, l.size()), ' ');
                 }
+                data = copy.data();
+                break;
             }
-            r.clear();
-            ++pos;
         }
     }
+};
 
-    fmt::print("2: {}\n", sum);
-}
 
-int main()
+Aoc::Answer part2(Input const& in)
 {
-    Rows values;
-    StringVect ops;
+    StringVect const& input{in.lines};
+    std::string_view const ops{input.back()};
+    const size_t width{input.at(0).size()};
 
-    StringVect input;
+    // the number of each column, read top down
+    const Grid grid{std::span{input}.first(input.size() - 1), width};
+    std::vector<uint64_t> numbers(width);
+    Aoc::Simd::column_numbers(grid.data, grid.stride, input.size() - 1, width, numbers.data());
 
-    std::string line;
-    while (std::getline(std::cin, line)) {
-        if (line.empty()) {
-            break;
-        }
-
-        input.push_back(line);
-
-        ops.clear();
+    uint64_t sum{0};
+    Row r;
 
-        boost::algorithm::trim(line);
-        boost::algorithm::split(ops, line, boost::is_any_of(" "), boost::algorithm::token_compress_on);
+    // walk the columns right to left, an operator closes a problem and the
+    // blank column left of it is skipped
+    for (size_t pos{0}; pos < width; ++pos) {
+        const size_t col{width - 1 - pos};
+        const char op{col < ops.size() ? ops[col] : ' '};
 
-        if (ops.at(0) == "+" || ops.at(0) == "*")
-            break;
+        r.push_back(numbers[col]);
 
-        Row r;
-        for (auto const& v : ops) {
-            r.push_back(std::stoull(&v[0]));
+        if (op == '+') {
+            sum += std::ranges::fold_left(r, 0, std::plus{});
         }
-        values.push_back(std::move(r));
+        else if (op == '*') {
+            if (std::ranges::find(r, 0) == r.cend()) {
+                sum += std::ranges::fold_left(r, 1, std::multiplies{});
+            }
+        }
+        else {
+            continue;
+        }
+        r.clear();
+        ++pos;
     }
 
-    assert(ops.size() == values.at(0).size());
+    return sum;
+}
 
-    part1(values, ops);
-    part2(input);
+}  // namespace day6
 
-    return 0;
-}
+const Aoc::Register registered{6, day6::parse, day6::part1, day6::part2};
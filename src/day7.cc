@@ -1,22 +1,44 @@
+#include "day.h"
+#include "flat_hash.h"
 #include "point2d.h"
 
+#include <algorithm>
+#include <cassert>
 #include <cstdint>
-#include <fmt/core.h>
+#include <string_view>
 
-#include <cassert>
-#include <iostream>
-#include <string>
-#include <unordered_map>
-#include <unordered_set>
+namespace day7 {
 
 using Coord = int32_t;
 using Point = Gfx_2d::Point<Coord>;
-using Map = std::unordered_map<Point, char>;
+using Map = Gfx_2d::Grid<char>;
+
+struct Input
+{
+    Map world;
+    Point start;
+};
 
-void part1(Map const& world, Point const& start)
+Input parse(std::string_view data)
 {
-    std::unordered_set<Point> s1, s2;
-    s1.insert(start + Gfx_2d::Down);
+    Input input{.world = Map::from_text(data, [](char c) { return c; })};
+
+    for (Coord y{0}; y < input.world.height(); ++y) {
+        auto const row{input.world.row(y)};
+        if (auto it{std::ranges::find(row, 'S')}; it != row.end()) {
+            input.start = Point{static_cast<Coord>(it - row.begin()), y};
+        }
+    }
+
+    return input;
+}
+
+Aoc::Answer part1(Input const& input)
+{
+    Map const& world{input.world};
+
+    Aoc::FlatSet<Point> s1, s2;
+    s1.insert(input.start + Gfx_2d::Down);
 
     unsigned splits{0};
 
@@ -24,12 +46,12 @@ void part1(Map const& world, Point const& start)
         s2.clear();
         for (auto px : s1) {
             Point next{px + Gfx_2d::Down};
-            if (!world.contains(next))
+            if (!world.inside(next))
                 continue;  // out of map
-            if (world.at(next) == '.') {
+            if (world[next] == '.') {
                 s2.insert(next);
             }
-            else if (world.at(next) == '^') {
+            else if (world[next] == '^') {
                 s2.insert(next + Gfx_2d::Left);
                 s2.insert(next + Gfx_2d::Right);
                 ++splits;
@@ -41,12 +63,12 @@ void part1(Map const& world, Point const& start)
         std::swap(s1, s2);
     }
 
-    fmt::print("1: {}\n", splits);
+    return splits;
 }
 
 class Part2
 {
-    std::unordered_map<Point, uint64_t> cache;
+    Aoc::FlatMap<Point, uint64_t> cache;
     Map const& world;
 
 public:
@@ -59,14 +81,14 @@ public:
     {
         Point px{start};
         for (;; px += Gfx_2d::Down) {
-            if (!world.contains(px))
+            if (!world.inside(px))
                 return 1;
 
-            if (world.at(px) == '^') {
+            if (world[px] == '^') {
                 break;
             }
         }
-        assert(world.at(px) == '^');
+        assert(world[px] == '^');
 
         if (cache.contains(px)) {
             return cache.at(px);
@@ -84,35 +106,12 @@ public:
 };
 
 
-int main()
+Aoc::Answer part2(Input const& input)
 {
-    Map world;
-    Point start;
-
-    {
-        Coord y{0};
-
-        std::string line;
-        while (std::getline(std::cin, line)) {
-            if (line.empty()) {
-                break;
-            }
-
-            Coord x{0};
-            for (char c : line) {
-                if (c == 'S') {
-                    start = Point{x, y};
-                }
-                world.insert({{x++, y}, c});
-            }
-            ++y;
-        }
-    }
-
-    part1(world, start);
+    Part2 d{input.world};
+    return d.beam(input.start);
+}
 
-    Part2 d{world};
-    fmt::print("2: {}\n", d.beam(start));
+}  // namespace day7
 
-    return 0;
-}
+const Aoc::Register registered{7, day7::parse, day7::part1, day7::part2};
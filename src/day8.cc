@@ -1,75 +1,270 @@
+#include "arena.h"
+#include "day.h"
+#include "embedded.h"
+#include "flat_hash.h"
+#include "input.h"
 #include "point3d.h"
+#include "scanner.h"
 
-#include <fmt/core.h>
-#include <fmt/ranges.h>
-
-#include <boost/algorithm/string/classification.hpp>
-#include <boost/algorithm/string/split.hpp>
+#if AOC_EMBED
+#include "day8_input.h"
+#endif
 
+#include <algorithm>
+#include <array>
 #include <cassert>
-#include <deque>
-#include <iostream>
 #include <map>
-#include <set>
+#include <memory_resource>
+#include <numeric>
+#include <span>
 #include <string>
-#include <unordered_set>
+#include <string_view>
+#include <tuple>
+
+namespace day8 {
 
 using Coord = int64_t;
 using Point = Gfx_3d::Point<Coord>;
-using Points = std::unordered_set<Point>;
-using PointMap = std::unordered_map<Point, int>;
+using Points = Aoc::Table<Point>;  // sorted, no duplicates
+using PointMap = Aoc::FlatMap<Point, int>;
+
+using Cloud = Gfx_3d::PointCloud<Coord>;
 
 struct Connection {
-    Point from, to;
-    double dist;
+    uint32_t from, to;  // indices into the points
+    Cloud::Distance dist;  // squared
+};
+
+
+template<typename OnPoint>
+constexpr void scan(std::string_view data, OnPoint&& on_point)
+{
+    for (std::string_view line : Aoc::Lines{data}) {
+        if (line.empty())
+            break;
+
+        std::array<Coord, 3> xyz{};
+        Aoc::parse_list(line, std::span{xyz});
+        on_point(Point{xyz[0], xyz[1], xyz[2]});
+    }
+}
+
+
+// Sorts the points and moves the distinct ones to the front, returns their count.
+constexpr size_t make_unique(std::span<Point> points)
+{
+    std::ranges::sort(points);
+    return std::ranges::unique(points).begin() - points.begin();
+}
+
+
+Points parse(std::string_view data)
+{
+    std::pmr::vector<Point> points{Aoc::run_resource()};
+    scan(data, [&](Point const& px) { points.push_back(px); });
+    points.resize(make_unique(points));
+    return points;
+}
+
+
+#if AOC_EMBED
+
+namespace embedded {
+
+constexpr size_t count(std::string_view data)
+{
+    size_t n{0};
+    scan(data, [&](Point const&) { ++n; });
+    return n;
+}
+
+template<size_t N>
+struct Parsed
+{
+    std::array<Point, N> points{};  // distinct ones first
+    size_t distinct{0};
 };
 
-unsigned get_id()
+template<size_t N>
+constexpr Parsed<N> parse(std::string_view data)
+{
+    Parsed<N> p;
+    size_t i{0};
+    scan(data, [&](Point const& px) { p.points[i++] = px; });
+    p.distinct = make_unique(p.points);
+    return p;
+}
+
+constexpr auto parsed{parse<count(Aoc::Embedded::day8)>(Aoc::Embedded::day8)};
+
+constinit const auto points{Aoc::take<parsed.distinct>(parsed.points)};
+
+}  // namespace embedded
+
+
+Points builtin()
 {
-    static int last = 0;
-    return ++last;
+    return embedded::points;
+}
+
+#endif
+
+
+std::pmr::vector<Connection> make_connections(Points const& points)
+{
+    const Cloud cloud{points, Aoc::run_resource()};
+
+    std::pmr::vector<Connection> connections{Aoc::run_resource()};
+    connections.reserve(points.size() * (points.size() - 1) / 2);
+    cloud.all_pairs(
+            [&](size_t i, size_t j, Cloud::Distance d)
+            {
+                connections.push_back({.from = static_cast<uint32_t>(i), .to = static_cast<uint32_t>(j), .dist = d});
+            });
+
+    // ties broken by the points, so the order does not depend on the sort
+    std::ranges::sort(connections,
+                      [](const auto& a, const auto& b)
+                      { return std::tie(a.dist, a.from, a.to) < std::tie(b.dist, b.from, b.to); });
+    return connections;
 }
 
 
-void process(Points const& points)
+// Union-find over the point indices: joining is near constant time where
+// relabelling a merged circuit walked all points.
+class Circuits
 {
-    auto print_part1 = [](const PointMap& pm)
+    std::pmr::vector<uint32_t> parent;
+    std::pmr::vector<uint32_t> size;
+    size_t count;
+
+    uint32_t root(uint32_t i)
     {
-        std::map<int, std::vector<Point>> g1;
-        for (auto const& [px, id] : pm) {
-            g1[id].push_back(px);
+        while (parent[i] != i) {
+            i = parent[i] = parent[parent[i]];
         }
+        return i;
+    }
 
-        std::vector<size_t> sizes;
-        for (auto const& [id, group] : g1) {
-            if (id)
-                sizes.push_back(group.size());
+public:
+    explicit Circuits(size_t points)
+        : parent(points, Aoc::run_resource())
+        , size(points, 1, Aoc::run_resource())
+        , count {points}
+    {
+        std::iota(parent.begin(), parent.end(), 0u);
+    }
+
+    void join(Connection const& c)
+    {
+        auto a{root(c.from)}, b{root(c.to)};
+        if (a == b) {
+            return;
         }
-        std::ranges::sort(sizes, std::greater{});
-        fmt::print("1: {}\n", sizes.at(0) * sizes.at(1) * sizes.at(2));
-    };
+        if (size[a] < size[b]) {
+            std::swap(a, b);
+        }
+        parent[b] = a;
+        size[a] += size[b];
+        --count;
+    }
 
-    PointMap pointmap;
-    for (auto const& px : points) {
-        pointmap.insert({px, 0});
+    bool complete() const { return count == 1; }
+
+    uint64_t largest_three() const
+    {
+        std::array<uint64_t, 3> top{};
+        for (uint32_t i{0}; i < parent.size(); ++i) {
+            // lone points are no circuit
+            if (parent[i] == i && size[i] > 1 && size[i] > top[2]) {
+                top[2] = size[i];
+                std::ranges::sort(top, std::greater{});
+            }
+        }
+        return top[0] * top[1] * top[2];
+    }
+};
+
+
+Aoc::Answer part1(Points const& points)
+{
+    Circuits circuits{points.size()};
+
+    int iter{0};
+    for (auto const& c : make_connections(points)) {
+        circuits.join(c);
+        if (++iter == 1000) {
+            break;
+        }
     }
 
-    std::vector<Connection> connections;
-    for (auto it1{points.cbegin()}; it1 != points.cend(); ++it1) {
-        for (auto it2{std::next(it1)}; it2 != points.cend(); ++it2) {
+    return circuits.largest_three();
+}
+
+
+Aoc::Answer part2(Points const& points)
+{
+    Circuits circuits{points.size()};
+
+    int iter{0};
+    for (auto const& c : make_connections(points)) {
+        circuits.join(c);
+        if (++iter >= 10 && circuits.complete()) {
+            return points.span()[c.from].x * points.span()[c.to].x;
+        }
+    }
+
+    return 0;
+}
+
+
+// The original engine: connections ordered by floating point distance,
+// circuit ids per point, a merge relabels the points of the higher id one by
+// one.
+namespace reference {
+
+struct Connection {
+    Point from, to;
+    double dist;
+};
+
+
+std::pmr::vector<Connection> make_connections(Points const& points)
+{
+    std::pmr::vector<Connection> connections{Aoc::run_resource()};
+    connections.reserve(points.size() * (points.size() - 1) / 2);
+    for (auto it1{points.begin()}; it1 != points.end(); ++it1) {
+        for (auto it2{std::next(it1)}; it2 != points.end(); ++it2) {
             connections.push_back({.from = *it1, .to = *it2, .dist = it1->euclidean_dist(*it2)});
         }
     }
 
     std::ranges::sort(connections, [](const auto& a, const auto& b) { return a.dist < b.dist; });
+    return connections;
+}
+
 
+class Circuits
+{
+    PointMap pointmap;
     std::map<unsigned, unsigned> ids;
-    ids.insert({0u, pointmap.size()});
+    int last_id{0};
 
-    int iter{0};
-    for (auto const& c : connections) {
-        auto& id1{pointmap.at(c.from)};
-        auto& id2{pointmap.at(c.to)};
+    int get_id() { return ++last_id; }
+
+public:
+    Circuits(Points const& points)
+    {
+        for (auto const& px : points) {
+            pointmap.insert({px, 0});
+        }
+        ids.insert({0u, pointmap.size()});
+    }
+
+    void join(Point const& from, Point const& to)
+    {
+        auto& id1{pointmap.at(from)};
+        auto& id2{pointmap.at(to)};
 
         if (id1 == 0 && id2 == 0) {
             ids.at(id1) -= 1;
@@ -100,36 +295,67 @@ void process(Points const& points)
             ids.erase(old_id);
         }
         assert(id1 == id2);
-        if (++iter == 1000) {
-            print_part1(pointmap);
+    }
+
+    // the first circuit always keeps id 1, merges go to the lower id
+    bool complete() const { return ids.contains(1) && ids.at(1) == pointmap.size(); }
+
+    uint64_t largest_three() const
+    {
+        std::map<int, std::vector<Point>> g1;
+        for (auto const& [px, id] : pointmap) {
+            g1[id].push_back(px);
         }
 
-        if (iter >= 10 && ids.contains(1) && ids.at(1) == pointmap.size()) {
-            fmt::print("2: {}\n", c.from.x * c.to.x);
-            break;
+        std::vector<size_t> sizes;
+        for (auto const& [id, group] : g1) {
+            if (id)
+                sizes.push_back(group.size());
         }
+        std::ranges::sort(sizes, std::greater{});
+        return sizes.at(0) * sizes.at(1) * sizes.at(2);
     }
-}
+};
+
 
-int main()
+Aoc::Answer part1(Points const& points)
 {
-    Points points;
+    Circuits circuits{points};
 
-    {
-        std::string line;
-        while (std::getline(std::cin, line)) {
-            if (line.empty())
-                break;
+    int iter{0};
+    for (auto const& c : make_connections(points)) {
+        circuits.join(c.from, c.to);
+        if (++iter == 1000) {
+            break;
+        }
+    }
 
-            std::deque<std::string> items;
-            boost::algorithm::split(items, line, boost::is_any_of(","), boost::algorithm::token_compress_on);
+    return circuits.largest_three();
+}
 
-            points.insert(
-                    Point{std::stoll(items[0].c_str()), std::stoll(items[1].c_str()), std::stoll(items[2].c_str())});
+
+Aoc::Answer part2(Points const& points)
+{
+    Circuits circuits{points};
+
+    int iter{0};
+    for (auto const& c : make_connections(points)) {
+        circuits.join(c.from, c.to);
+        if (++iter >= 10 && circuits.complete()) {
+            return c.from.x * c.to.x;
         }
     }
 
-    process(points);
-
     return 0;
 }
+
+}  // namespace reference
+
+}  // namespace day8
+
+#if AOC_EMBED
+const Aoc::Register registered{8, day8::parse, day8::part1, day8::part2, day8::builtin};
+#else
+const Aoc::Register registered{8, day8::parse, day8::part1, day8::part2};
+#endif
+const Aoc::RegisterReference reference{8, day8::reference::part1, day8::reference::part2};
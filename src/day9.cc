@@ -1,4 +1,9 @@
+#include "day.h"
+#include "flat_hash.h"
+#include "input.h"
 #include "point2d.h"
+#include "scanner.h"
+#include "scope.h"
 
 #include <fmt/core.h>
 #include <fmt/ranges.h>
@@ -6,55 +11,38 @@
 #include <algorithm>
 #include <cassert>
 #include <deque>
-#include <iostream>
 #include <iterator>
 #include <limits>
 #include <map>
 #include <optional>
 #include <string>
-#include <unordered_set>
 #include <vector>
 
+namespace day9 {
+
 using Coord = int;
 using Point = Gfx_2d::Point<Coord>;
-using Points = std::unordered_set<Point>;
+using Points = Aoc::FlatSet<Point>;
 
 
+// Position on the compressed grid, indices into World::map_x and map_y.
 struct Compressed
 {
-    static std::vector<Coord> map_x;
-    static std::vector<Coord> map_y;
-
-    std::vector<Coord>::iterator ix{map_x.end()}, iy{map_y.end()};
-
+    Coord cx{std::numeric_limits<Coord>::max()}, cy{std::numeric_limits<Coord>::max()};
 
     constexpr Compressed() noexcept = default;
-    constexpr Compressed(Point const& px) noexcept
-        : ix{std::ranges::find(map_x, px.x)}
-        , iy{std::ranges::find(map_y, px.y)}
-    {
-        assert(ix != map_x.cend());
-        assert(iy != map_y.cend());
-    }
-
     constexpr Compressed(Coord x_, Coord y_) noexcept
-        : ix{std::next(map_x.begin(), x_)}
-        , iy{std::next(map_y.begin(), y_)}
+        : cx{x_}
+        , cy{y_}
     {
     }
 
-    constexpr Compressed(Compressed const&) noexcept = default;
-    constexpr Compressed(Compressed&&) noexcept = default;
-
-    constexpr Compressed& operator= (Compressed const&) noexcept = default;
-    constexpr Compressed& operator= (Compressed&&) noexcept = default;
-
     constexpr auto operator<=> (Compressed const&) const = default;
 
     constexpr Compressed& operator+= (Gfx_2d::Direction const& o) noexcept
     {
-        std::advance(ix, o.dx);
-        std::advance(iy, o.dy);
+        cx += o.dx;
+        cy += o.dy;
         return *this;
     }
 
@@ -64,17 +52,11 @@ struct Compressed
         return lhs;
     }
 
-    Coord x() const { return ix != map_x.end() ? std::distance(map_x.begin(), ix) : std::numeric_limits<Coord>::max(); }
-    Coord y() const { return iy != map_y.end() ? std::distance(map_y.begin(), iy) : std::numeric_limits<Coord>::max(); }
-
-    Point to_point() const { return {*ix, *iy}; }
+    constexpr Coord x() const noexcept { return cx; }
+    constexpr Coord y() const noexcept { return cy; }
 };
 
 
-std::vector<Coord> Compressed::map_x;
-std::vector<Coord> Compressed::map_y;
-
-
 struct Square
 {
     Point a, b;
@@ -82,54 +64,81 @@ struct Square
 };
 
 
+Square minmax_area(Points const& points)
+{
+    AOC_SCOPE("day9/minmax_area");
+
+    std::multimap<int64_t, Square> areas;
+
+    for (auto it1{points.begin()}; it1 != points.end(); ++it1) {
+        auto const& p1{*it1};
+        for (auto it2{std::next(it1)}; it2 != points.end(); ++it2) {
+            auto const& p2{*it2};
+            const int64_t dx{std::abs(p2.x - p1.x) + 1};
+            const int64_t dy{std::abs(p2.y - p1.y) + 1};
+            const int64_t area{dx * dy};
+
+            areas.insert({area, Square{.a = std::min(p1, p2), .b = std::max(p1, p2), .area = area}});
+        }
+    }
+
+    return areas.rbegin()->second;
+}
+
+
 struct World
 {
     Points const& points;
 
-    Coord min_x{std::numeric_limits<Coord>::max()}, min_y{std::numeric_limits<Coord>::max()}, max_x{0}, max_y{0};
+    std::vector<Coord> map_x, map_y;  // sorted distinct coordinates of the points
 
-    std::string data;
+    Coord min_x{std::numeric_limits<Coord>::max()}, min_y{std::numeric_limits<Coord>::max()}, max_x{0}, max_y{0};
 
-    Square max_a;
+    Gfx_2d::Grid<char> data;
 
 
     World(Points const& p)
         : points{p}
     {
-        minmax_area();
-
         for (auto const& px : points) {
-            Compressed::map_x.push_back(px.x);
-            Compressed::map_y.push_back(px.y);
+            map_x.push_back(px.x);
+            map_y.push_back(px.y);
         }
 
-        std::ranges::sort(Compressed::map_x);
-        std::ranges::sort(Compressed::map_y);
+        std::ranges::sort(map_x);
+        std::ranges::sort(map_y);
 
-        Compressed::map_x.erase(std::unique(Compressed::map_x.begin(), Compressed::map_x.end()), Compressed::map_x.end());
-        Compressed::map_y.erase(std::unique(Compressed::map_y.begin(), Compressed::map_y.end()), Compressed::map_y.end());
+        map_x.erase(std::unique(map_x.begin(), map_x.end()), map_x.end());
+        map_y.erase(std::unique(map_y.begin(), map_y.end()), map_y.end());
 
         min_x = min_y = 0;
-        max_x = Compressed::map_x.size();
-        max_y = Compressed::map_y.size();
+        max_x = map_x.size();
+        max_y = map_y.size();
 
-        data.resize(max_y * max_x, '.');
+        data = Gfx_2d::Grid<char>(max_x, max_y, '.');
 
         for (auto const& px : points) {
-            set(Compressed{px}, '#');
+            set(compress(px), '#');
         }
     }
 
-    char get(Compressed const& px) const { return data.at(px.y() * max_x + px.x()); }
-    void set(Compressed const& px, char c) { data.at(px.y() * max_x + px.x()) = c; }
-
-    bool inside(Compressed const& px) const
+    Compressed compress(Point const& px) const
     {
-        return px.x() >= 0 && px.x() < max_x && px.y() >= 0 && px.y() < max_y
-                && (px.y() * max_x + px.x()) < (max_y * max_x);
-    };
+        auto ix{std::ranges::lower_bound(map_x, px.x)};
+        auto iy{std::ranges::lower_bound(map_y, px.y)};
+        assert(ix != map_x.end() && *ix == px.x);
+        assert(iy != map_y.end() && *iy == px.y);
+        return {static_cast<Coord>(ix - map_x.begin()), static_cast<Coord>(iy - map_y.begin())};
+    }
+
+    static Point cell(Compressed const& px) { return {px.x(), px.y()}; }
+
+    char get(Compressed const& px) const { return data[cell(px)]; }
+    void set(Compressed const& px, char c) { data[cell(px)] = c; }
+
+    bool inside(Compressed const& px) const { return data.inside(cell(px)); }
 
-    bool contains(Compressed const& px) const { return data.at(px.y() * max_x + px.x()) != '.'; }
+    bool contains(Compressed const& px) const { return data[cell(px)] != '.'; }
 
 
     void dump_points() const
@@ -147,33 +156,13 @@ struct World
 
     void dump_data() const
     {
-        std::string_view v{data};
         for (Coord y = 0; y < max_y; ++y) {
-            fmt::print("{}\n", v.substr(y * max_x, max_x));
+            auto const row{data.row(y)};
+            fmt::print("{}\n", std::string_view{row.data(), row.size()});
         }
         fmt::print("\n");
     }
 
-    void minmax_area()
-    {
-        std::multimap<int64_t, Square> areas;
-
-        for (auto it1{points.begin()}; it1 != points.end(); ++it1) {
-            auto const& p1{*it1};
-            for (auto it2{std::next(it1)}; it2 != points.end(); ++it2) {
-                auto const& p2{*it2};
-                const int64_t dx{std::abs(p2.x - p1.x) + 1};
-                const int64_t dy{std::abs(p2.y - p1.y) + 1};
-                const int64_t area{dx * dy};
-
-                areas.insert({area, Square{.a = std::min(p1, p2), .b = std::max(p1, p2), .area = area}});
-            }
-        }
-
-        max_a = areas.rbegin()->second;
-    }
-
-
     void make_line(Compressed const& from, Compressed const& to)
     {
         Gfx_2d::Direction dir;
@@ -196,9 +185,7 @@ struct World
         }
     }
 
-    void part1() { fmt::print("1: {}\n", max_a.area); }
-
-    void part2()
+    int64_t part2()
     {
         for (auto it1{points.begin()}; it1 != points.end(); ++it1) {
             auto const& p1{*it1};
@@ -207,11 +194,11 @@ struct World
                 auto const& p2{*it2};
                 if (p1.x == p2.x) {
                     hasY = true;
-                    make_line(p1, p2);
+                    make_line(compress(p1), compress(p2));
                 }
                 else if (p1.y == p2.y) {
                     hasX = true;
-                    make_line(p1, p2);
+                    make_line(compress(p1), compress(p2));
                 }
 
                 if (hasX && hasY)
@@ -299,8 +286,8 @@ struct World
                     continue;
                 }
 
-                Compressed a{Point{std::min(from.x, to.x), std::min(from.y, to.y)}};
-                const Compressed b{Point{std::max(from.x, to.x), std::max(from.y, to.y)}};
+                Compressed a{compress({std::min(from.x, to.x), std::min(from.y, to.y)})};
+                const Compressed b{compress({std::max(from.x, to.x), std::max(from.y, to.y)})};
 
                 bool fail{false};
                 for (Compressed outer{a}; outer.y() <= b.y(); outer += Gfx_2d::Down) {
@@ -323,31 +310,42 @@ struct World
             }
         }
 
-        fmt::print("2: {}\n", full_a.area);
+        return full_a.area;
     }
 };
 
 
-int main()
+Points parse(std::string_view data)
 {
     Points points;
 
-    {
-        std::string line;
-        while (std::getline(std::cin, line)) {
-            if (line.empty())
-                break;
-
-            const auto sep{line.find(',')};
-            line.at(sep) = '\0';
-            points.insert({std::stoi(&line[0]), std::stoi(&line[sep + 1])});
-        }
+    for (std::string_view line : Aoc::Lines{data}) {
+        if (line.empty())
+            break;
+
+        Aoc::Scanner scan{line};
+        Coord x{0}, y{0};
+        scan.next(x);
+        scan.next(y);
+        points.insert({x, y});
     }
 
-    World world(points);
+    return points;
+}
+
 
-    world.part1();
-    world.part2();
+Aoc::Answer part1(Points const& points)
+{
+    return minmax_area(points).area;
+}
 
-    return 0;
+
+Aoc::Answer part2(Points const& points)
+{
+    World world(points);
+    return world.part2();
 }
+
+}  // namespace day9
+
+const Aoc::Register registered{9, day9::parse, day9::part1, day9::part2};
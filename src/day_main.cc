@@ -0,0 +1,119 @@
+#include "arena.h"
+#include "day.h"
+#include "input.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <fmt/core.h>
+
+#include <chrono>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace {
+
+// Feeds the input to the day's LineSolver as it arrives, printing the
+// answers so far to stderr about once a second.
+int stream(Aoc::Day const& day, int argc, char** argv)
+{
+    if (!day.stream) {
+        fmt::print(stderr, "Day {} cannot stream its input\n", day.number);
+        return 1;
+    }
+
+    int fd{STDIN_FILENO};
+    if (argc > 2 && std::string_view{argv[2]} != "-") {
+        fd = ::open(argv[2], O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error(std::string{"Unable to open "} + argv[2]);
+        }
+    }
+
+    const auto solver{day.stream()};
+    auto next_report{std::chrono::steady_clock::now() + std::chrono::seconds{1}};
+    uint64_t lines{0};
+
+    Aoc::read_lines(fd,
+                    [&](std::string_view line)
+                    {
+                        if ((++lines & 0xffff) == 0 && std::chrono::steady_clock::now() >= next_report) {
+                            fmt::print(stderr, "{} lines: 1: {} 2: {}\n", lines, solver->part1(), solver->part2());
+                            next_report += std::chrono::seconds{1};
+                        }
+                        return solver->line(line);
+                    });
+
+    if (fd != STDIN_FILENO) {
+        ::close(fd);
+    }
+
+    fmt::print("1: {}\n", solver->part1());
+    if (day.part2) {
+        fmt::print("2: {}\n", solver->part2());
+    }
+    return 0;
+}
+
+
+// Solves the mapped input with the day's parallel scan.
+int scan(Aoc::Day const& day, int argc, char** argv)
+{
+    if (!day.scan) {
+        fmt::print(stderr, "Day {} cannot scan its input in parallel\n", day.number);
+        return 1;
+    }
+
+    const Aoc::MappedInput input{argc - 1, argv + 1};
+    const auto [answer1, answer2] {day.scan(input.data())};
+
+    fmt::print("1: {}\n", answer1);
+    if (day.part2) {
+        fmt::print("2: {}\n", answer2);
+    }
+    return 0;
+}
+
+}  // namespace
+
+
+// Stand-alone executable for a single day: input file as the first argument
+// or on stdin, answers printed as before the days were split into phases.
+// With -e a day built with AOC_EMBED solves its compiled-in input, with
+// -s [FILE] a streaming day reads its input chunk by chunk in bounded memory,
+// with -p [FILE] a scanning day solves its mapped input on all cores.
+int main(int argc, char** argv)
+{
+    const std::string_view mode{argc > 1 ? argv[1] : ""};
+    if (mode == "-s" && !Aoc::days().empty()) {
+        return stream(Aoc::days().front(), argc, argv);
+    }
+    if (mode == "-p" && !Aoc::days().empty()) {
+        return scan(Aoc::days().front(), argc, argv);
+    }
+
+    const bool builtin{mode == "-e"};
+    std::optional<Aoc::MappedInput> input;
+    if (!builtin) {
+        input.emplace(argc, argv);
+    }
+    Aoc::RunArena arena;
+    const Aoc::RunArena::Use use{arena};
+
+    for (auto const& day : Aoc::days()) {
+        if (builtin && !day.builtin) {
+            fmt::print(stderr, "Day {} has no compiled-in input\n", day.number);
+            return 1;
+        }
+        const auto parsed{builtin ? day.builtin() : day.parse(input->data())};
+
+        fmt::print("1: {}\n", day.part1(parsed));
+        if (day.part2) {
+            fmt::print("2: {}\n", day.part2(parsed));
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+#include <span>
+#include <utility>
+#include <variant>
+#include <vector>
+
+// Inputs compiled into the binary (-DAOC_EMBED=ON). CMake writes dayN.txt
+// into <build>/embedded/dayN_input.h as Aoc::Embedded::dayN, a constexpr
+// string_view; the day parses it in constexpr functions into constinit
+// tables and registers a function handing those out in place of parse():
+//
+//   const Aoc::Register registered{5, day5::parse, day5::part1, day5::part2, day5::builtin};
+//
+// aoc -e and dayN -e then start directly at the solver.
+namespace Aoc {
+
+// Contiguous input data, either parsed at run time (owned, from the run
+// arena) or borrowed from a constinit table.
+template<typename T>
+class Table
+{
+    std::variant<std::span<T const>, std::pmr::vector<T>> data;
+
+public:
+    Table(std::pmr::vector<T> owned) noexcept
+        : data {std::move(owned)}
+    { }
+
+    template<size_t N>
+    constexpr Table(std::array<T, N> const& table) noexcept
+        : data {std::span<T const>{table}}
+    { }
+
+    std::span<T const> span() const noexcept
+    {
+        return std::visit([](auto const& d) { return std::span<T const>{d}; }, data);
+    }
+
+    size_t size() const noexcept { return span().size(); }
+    T const* begin() const noexcept { return span().data(); }
+    T const* end() const noexcept { return begin() + size(); }
+};
+
+
+// The first N elements of a constant array, for sizing a constinit table
+// once the constexpr parse knows how many it produced.
+template<size_t N, typename T, size_t M>
+    requires(N <= M)
+constexpr std::array<T, N> take(std::array<T, M> const& from)
+{
+    std::array<T, N> to{};
+    std::ranges::copy_n(from.begin(), N, to.begin());
+    return to;
+}
+
+}  // namespace Aoc
@@ -0,0 +1,266 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Open-addressing hash set and map for keys that pack into 64 bits, such as
+// Gfx_2d::Point<int32_t> or bounded Gfx_3d points (see packed_key() next to
+// each point type). Slots live in one flat array with linear probing, so
+// lookups touch one or two cache lines instead of chasing node pointers.
+// Iterators and references are invalidated by any insertion.
+namespace Aoc {
+
+// murmur3 finalizer, spreads packed coordinates over all bits
+constexpr uint64_t mix64(uint64_t k) noexcept
+{
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccd;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53;
+    k ^= k >> 33;
+    return k;
+}
+
+template<std::integral T>
+constexpr uint64_t packed_key(T v) noexcept
+{
+    return static_cast<uint64_t>(v);
+}
+
+template<typename Key>
+concept Packable = requires(Key const& k) {
+    { packed_key(k) } -> std::convertible_to<uint64_t>;
+};
+
+
+namespace detail {
+
+template<typename Key, typename Slot>
+class FlatTable
+{
+    static constexpr size_t min_capacity{16};
+
+    std::vector<Slot> slots;
+    std::vector<uint8_t> used;
+    size_t count{0};
+
+    static Key const& key_of(Key const& k) noexcept { return k; }
+
+    template<typename Value>
+    static Key const& key_of(std::pair<Key, Value> const& s) noexcept
+    {
+        return s.first;
+    }
+
+    size_t home(Key const& key) const noexcept { return mix64(packed_key(key)) & (slots.size() - 1); }
+
+    // slot holding key, or the empty slot where it would go
+    size_t probe(Key const& key) const noexcept
+    {
+        const size_t mask{slots.size() - 1};
+        size_t i{home(key)};
+        while (used[i] && !(key_of(slots[i]) == key)) {
+            i = (i + 1) & mask;
+        }
+        return i;
+    }
+
+    void grow_for(size_t n)
+    {
+        if (n * 4 <= slots.size() * 3) {
+            return;
+        }
+        size_t capacity{std::max(min_capacity, slots.size())};
+        while (n * 4 > capacity * 3) {
+            capacity *= 2;
+        }
+
+        auto old_slots{std::exchange(slots, std::vector<Slot>(capacity))};
+        auto old_used{std::exchange(used, std::vector<uint8_t>(capacity, 0))};
+        for (size_t i{0}; i < old_slots.size(); ++i) {
+            if (old_used[i]) {
+                const size_t to{probe(key_of(old_slots[i]))};
+                slots[to] = std::move(old_slots[i]);
+                used[to] = 1;
+            }
+        }
+    }
+
+public:
+    template<bool Const>
+    class Iterator
+    {
+        using Table = std::conditional_t<Const, FlatTable const, FlatTable>;
+
+        Table* table{nullptr};
+        size_t pos{0};
+
+        void skip() noexcept
+        {
+            while (pos < table->used.size() && !table->used[pos]) {
+                ++pos;
+            }
+        }
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Slot;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<Const, Slot const*, Slot*>;
+        using reference = std::conditional_t<Const, Slot const&, Slot&>;
+
+        Iterator() = default;
+        Iterator(Table* t, size_t p) noexcept
+            : table {t}
+            , pos {p}
+        {
+            skip();
+        }
+
+        operator Iterator<true>() const noexcept { return {table, pos}; }
+
+        reference operator*() const noexcept { return table->slots[pos]; }
+        pointer operator->() const noexcept { return &table->slots[pos]; }
+
+        Iterator& operator++() noexcept
+        {
+            ++pos;
+            skip();
+            return *this;
+        }
+
+        Iterator operator++(int) noexcept
+        {
+            auto old{*this};
+            ++*this;
+            return old;
+        }
+
+        bool operator==(Iterator const& o) const noexcept { return pos == o.pos; }
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    size_t size() const noexcept { return count; }
+    bool empty() const noexcept { return count == 0; }
+
+    void reserve(size_t n) { grow_for(n); }
+
+    // keeps the capacity
+    void clear() noexcept
+    {
+        std::ranges::fill(used, 0);
+        count = 0;
+    }
+
+    iterator begin() noexcept { return {this, 0}; }
+    iterator end() noexcept { return {this, used.size()}; }
+    const_iterator begin() const noexcept { return {this, 0}; }
+    const_iterator end() const noexcept { return {this, used.size()}; }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    iterator find(Key const& key) noexcept
+    {
+        if (!count) {
+            return end();
+        }
+        const size_t i{probe(key)};
+        return used[i] ? iterator{this, i} : end();
+    }
+
+    const_iterator find(Key const& key) const noexcept
+    {
+        if (!count) {
+            return end();
+        }
+        const size_t i{probe(key)};
+        return used[i] ? const_iterator{this, i} : end();
+    }
+
+    bool contains(Key const& key) const noexcept { return find(key) != end(); }
+
+    std::pair<iterator, bool> insert(Slot slot)
+    {
+        grow_for(count + 1);
+        const size_t i{probe(key_of(slot))};
+        if (used[i]) {
+            return {{this, i}, false};
+        }
+        slots[i] = std::move(slot);
+        used[i] = 1;
+        ++count;
+        return {{this, i}, true};
+    }
+
+    // backward-shift deletion, no tombstones
+    size_t erase(Key const& key) noexcept
+    {
+        if (!count) {
+            return 0;
+        }
+        const size_t mask{slots.size() - 1};
+        size_t hole{probe(key)};
+        if (!used[hole]) {
+            return 0;
+        }
+        for (size_t i{(hole + 1) & mask}; used[i]; i = (i + 1) & mask) {
+            const size_t h{home(key_of(slots[i]))};
+            // move back unless its home lies cyclically in (hole, i]
+            if (((i - h) & mask) >= ((i - hole) & mask)) {
+                slots[hole] = std::move(slots[i]);
+                hole = i;
+            }
+        }
+        used[hole] = 0;
+        --count;
+        return 1;
+    }
+};
+
+}  // namespace detail
+
+
+template<Packable Key>
+class FlatSet : public detail::FlatTable<Key, Key>
+{ };
+
+
+template<Packable Key, typename Value>
+class FlatMap : public detail::FlatTable<Key, std::pair<Key, Value>>
+{
+    using Base = detail::FlatTable<Key, std::pair<Key, Value>>;
+
+public:
+    using Base::insert;
+
+    Value& operator[](Key const& key) { return this->insert({key, Value{}}).first->second; }
+
+    Value& at(Key const& key)
+    {
+        auto it{this->find(key)};
+        if (it == this->end()) {
+            throw std::out_of_range{"FlatMap::at"};
+        }
+        return it->second;
+    }
+
+    Value const& at(Key const& key) const
+    {
+        auto it{this->find(key)};
+        if (it == this->end()) {
+            throw std::out_of_range{"FlatMap::at"};
+        }
+        return it->second;
+    }
+};
+
+}  // namespace Aoc
@@ -0,0 +1,380 @@
+#pragma once
+
+#include <fmt/core.h>
+#include <fmt/ranges.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <numeric>
+#include <set>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Deterministic synthetic inputs in each day's format. The same (n, seed)
+// always produces the same bytes, independent of the standard library, so
+// timings of different builds and machines can be compared.
+namespace Aoc::Gen {
+
+// splitmix64
+class Rng
+{
+    uint64_t state;
+
+public:
+    constexpr explicit Rng(uint64_t seed) noexcept
+        : state {seed}
+    { }
+
+    constexpr uint64_t next() noexcept
+    {
+        uint64_t z{state += 0x9e3779b97f4a7c15};
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+        return z ^ (z >> 31);
+    }
+
+    // uniform-ish value in [lo, hi]
+    constexpr uint64_t between(uint64_t lo, uint64_t hi) noexcept { return lo + next() % (hi - lo + 1); }
+
+    constexpr bool chance(unsigned percent) noexcept { return next() % 100 < percent; }
+};
+
+
+// n rotations
+inline std::string day1(size_t n, uint64_t seed)
+{
+    Rng rng{seed};
+    std::string out;
+    for (size_t i{0}; i < n; ++i) {
+        fmt::format_to(std::back_inserter(out), "{}{}\n", rng.chance(50) ? 'L' : 'R', rng.between(1, 999));
+    }
+    return out;
+}
+
+
+// n ranges of up to 5000 IDs each, 2 to 10 digits long
+inline std::string day2(size_t n, uint64_t seed)
+{
+    Rng rng{seed};
+    std::string out;
+    for (size_t i{0}; i < n; ++i) {
+        const auto digits{rng.between(2, 10)};
+        uint64_t lo{1};
+        for (uint64_t d{1}; d < digits; ++d) {
+            lo *= 10;
+        }
+        const uint64_t from{rng.between(lo, lo * 10 - 1)};
+        fmt::format_to(std::back_inserter(out), "{}{}-{}", i ? "," : "", from, from + rng.between(10, 5000));
+    }
+    out += '\n';
+    return out;
+}
+
+
+// n banks of 100 batteries
+inline std::string day3(size_t n, uint64_t seed)
+{
+    Rng rng{seed};
+    std::string out;
+    out.reserve(n * 101);
+    for (size_t i{0}; i < n; ++i) {
+        for (int j{0}; j < 100; ++j) {
+            out += static_cast<char>('1' + rng.between(0, 8));
+        }
+        out += '\n';
+    }
+    return out;
+}
+
+
+// n x n grid, about 60% rolls
+inline std::string day4(size_t n, uint64_t seed)
+{
+    Rng rng{seed};
+    std::string out;
+    out.reserve(n * (n + 1));
+    for (size_t y{0}; y < n; ++y) {
+        for (size_t x{0}; x < n; ++x) {
+            out += rng.chance(60) ? '@' : '.';
+        }
+        out += '\n';
+    }
+    return out;
+}
+
+
+// n fresh ranges followed by n ingredient IDs
+inline std::string day5(size_t n, uint64_t seed)
+{
+    constexpr uint64_t max_id{1'000'000'000'000'000};
+
+    Rng rng{seed};
+    std::string out;
+    for (size_t i{0}; i < n; ++i) {
+        const uint64_t from{rng.between(1, max_id)};
+        fmt::format_to(std::back_inserter(out), "{}-{}\n", from, from + rng.between(0, 1'000'000'000'000));
+    }
+    out += '\n';
+    for (size_t i{0}; i < n; ++i) {
+        fmt::format_to(std::back_inserter(out), "{}\n", rng.between(1, max_id));
+    }
+    return out;
+}
+
+
+// n problems of four numbers, columns aligned like the puzzle worksheet
+inline std::string day6(size_t n, uint64_t seed)
+{
+    constexpr size_t rows{4};
+
+    Rng rng{seed};
+    std::vector<std::string> lines(rows + 1);
+
+    for (size_t p{0}; p < n; ++p) {
+        const auto width{rng.between(1, 4)};
+        const auto full{rng.between(0, rows - 1)};
+        const bool left{rng.chance(50)};
+
+        for (size_t r{0}; r < rows; ++r) {
+            const auto digits{r == full ? width : rng.between(1, width)};
+            std::string num;
+            for (uint64_t d{0}; d < digits; ++d) {
+                num += static_cast<char>('1' + rng.between(0, 8));
+            }
+            if (p) {
+                lines[r] += ' ';
+            }
+            lines[r] += left ? fmt::format("{:<{}}", num, width) : fmt::format("{:>{}}", num, width);
+        }
+
+        if (p) {
+            lines[rows] += ' ';
+        }
+        lines[rows] += fmt::format("{:<{}}", rng.chance(50) ? '+' : '*', width);
+    }
+
+    std::string out;
+    for (auto const& line : lines) {
+        out += line;
+        out += '\n';
+    }
+    return out;
+}
+
+
+// n x n manifold, splitters on every other row and never side by side
+inline std::string day7(size_t n, uint64_t seed)
+{
+    Rng rng{seed};
+    std::string out;
+    out.reserve(n * (n + 1));
+    for (size_t y{0}; y < n; ++y) {
+        for (size_t x{0}; x < n; ++x) {
+            if (y == 0) {
+                out += x == n / 2 ? 'S' : '.';
+            }
+            else {
+                const bool free{x == 0 || out.back() != '^'};
+                out += (y % 2 == 0 && free && rng.chance(30)) ? '^' : '.';
+            }
+        }
+        out += '\n';
+    }
+    return out;
+}
+
+
+// n junction boxes in a 100000^3 cube
+inline std::string day8(size_t n, uint64_t seed)
+{
+    Rng rng{seed};
+    std::string out;
+    for (size_t i{0}; i < n; ++i) {
+        fmt::format_to(
+                std::back_inserter(out),
+                "{},{},{}\n",
+                rng.between(0, 99999),
+                rng.between(0, 99999),
+                rng.between(0, 99999));
+    }
+    return out;
+}
+
+
+// rectilinear polygon with about n vertices: a histogram of n/2 - 1 bars
+// with distinct heights, so every x and every y is shared by exactly two
+// vertices as in the puzzle input
+inline std::string day9(size_t n, uint64_t seed)
+{
+    Rng rng{seed};
+
+    const size_t bars{std::max<size_t>(n / 2, 2) - 1};
+
+    auto distinct = [&rng](size_t count, uint64_t lo, uint64_t hi)
+    {
+        std::set<uint64_t> values;
+        while (values.size() < count) {
+            values.insert(rng.between(lo, hi));
+        }
+        return std::vector<uint64_t>{values.begin(), values.end()};
+    };
+
+    const auto xs{distinct(bars + 1, 1, 99999)};
+    auto heights{distinct(bars, 1000, 99999)};
+    for (size_t i{heights.size()}; i > 1; --i) {
+        std::swap(heights[i - 1], heights[rng.between(0, i - 1)]);
+    }
+
+    std::string out;
+    fmt::format_to(std::back_inserter(out), "{},{}\n", xs.front(), 100);
+    for (size_t i{0}; i < bars; ++i) {
+        fmt::format_to(std::back_inserter(out), "{},{}\n", xs[i], heights[i]);
+        fmt::format_to(std::back_inserter(out), "{},{}\n", xs[i + 1], heights[i]);
+    }
+    fmt::format_to(std::back_inserter(out), "{},{}\n", xs.back(), 100);
+    return out;
+}
+
+
+// n machines with 4-7 lights and up to 10 buttons; the expected lights and
+// joltages are built from random presses so every machine is solvable
+inline std::string day10(size_t n, uint64_t seed)
+{
+    Rng rng{seed};
+    std::string out;
+
+    for (size_t i{0}; i < n; ++i) {
+        const auto lights{rng.between(4, 7)};
+        const auto buttons{rng.between(lights - 1, std::min<uint64_t>(lights + 3, 10))};
+
+        std::string leds(lights, '.');
+        std::vector<uint64_t> joltage(lights, 0);
+        std::string groups;
+
+        for (uint64_t b{0}; b < buttons; ++b) {
+            std::vector<uint64_t> wires;
+            for (uint64_t l{0}; l < lights; ++l) {
+                if (rng.chance(40)) {
+                    wires.push_back(l);
+                }
+            }
+            if (wires.empty()) {
+                wires.push_back(rng.between(0, lights - 1));
+            }
+
+            const bool toggled{rng.chance(50)};
+            const auto presses{rng.between(0, 20)};
+            for (auto w : wires) {
+                if (toggled) {
+                    leds[w] = leds[w] == '.' ? '#' : '.';
+                }
+                joltage[w] += presses;
+            }
+
+            fmt::format_to(std::back_inserter(groups), " ({})", fmt::join(wires, ","));
+        }
+
+        fmt::format_to(std::back_inserter(out), "[{}]{} {{{}}}\n", leds, groups, fmt::join(joltage, ","));
+    }
+
+    return out;
+}
+
+
+// n devices: a chain svr -> ... -> out through you, fft and dac, every
+// device also wired to a few dead ends so the graph is not a plain list
+inline std::string day11(size_t n, uint64_t seed)
+{
+    Rng rng{seed};
+    n = std::max<size_t>(n, 8);
+
+    auto name = [](size_t i)
+    {
+        std::string s;
+        do {
+            s += static_cast<char>('a' + i % 26);
+            i /= 26;
+        } while (i);
+        s.resize(std::max<size_t>(s.size(), 4), 'a');
+        std::ranges::reverse(s);
+        return s;
+    };
+
+    const size_t chain{n / 2};
+    std::vector<std::string> nodes;
+    for (size_t i{0}; i < chain; ++i) {
+        nodes.push_back(name(i));
+    }
+    nodes[0] = "svr";
+    nodes[1] = "you";
+    nodes[chain / 3] = "fft";
+    nodes[2 * chain / 3] = "dac";
+    nodes[chain - 1] = "out";
+
+    std::string out;
+    for (size_t i{0}; i + 1 < chain; ++i) {
+        fmt::format_to(std::back_inserter(out), "{}: {}", nodes[i], nodes[i + 1]);
+        for (auto k{rng.between(0, 2)}; k; --k) {
+            fmt::format_to(std::back_inserter(out), " {}", name(chain + rng.between(0, n - chain - 1)));
+        }
+        out += '\n';
+    }
+    return out;
+}
+
+
+// the six puzzle shapes followed by n regions
+inline std::string day12(size_t n, uint64_t seed)
+{
+    Rng rng{seed};
+    std::string out{
+            "0:\n#.#\n#.#\n###\n\n"
+            "1:\n###\n.#.\n###\n\n"
+            "2:\n###\n#..\n###\n\n"
+            "3:\n##.\n.##\n..#\n\n"
+            "4:\n###\n#.#\n#.#\n\n"
+            "5:\n#..\n###\n..#\n\n"};
+
+    for (size_t i{0}; i < n; ++i) {
+        fmt::format_to(std::back_inserter(out), "{}x{}:", rng.between(10, 50), rng.between(10, 50));
+        for (int s{0}; s < 6; ++s) {
+            fmt::format_to(std::back_inserter(out), " {}", rng.between(0, 60));
+        }
+        out += '\n';
+    }
+    return out;
+}
+
+
+struct Generator
+{
+    unsigned day;
+    std::string_view unit;
+    size_t min_n, max_n;
+    std::string (*make)(size_t n, uint64_t seed);
+};
+
+// Default sweep bounds keep the reference solvers within seconds per size.
+inline std::span<const Generator> generators()
+{
+    static constexpr Generator all[] {
+            {1, "rotations", 1000, 4'096'000, day1},
+            {2, "ranges", 10, 10240, day2},
+            {3, "banks", 1000, 1'024'000, day3},
+            {4, "grid side", 64, 2048, day4},
+            {5, "ranges", 1000, 1'024'000, day5},
+            {6, "problems", 1000, 1'024'000, day6},
+            {7, "grid side", 64, 4096, day7},
+            {8, "points", 1000, 4000, day8},
+            {9, "vertices", 8, 1024, day9},
+            {10, "machines", 1, 64, day10},
+            {11, "devices", 1000, 16000, day11},
+            {12, "regions", 1000, 1'024'000, day12},
+    };
+    return all;
+}
+
+}  // namespace Aoc::Gen
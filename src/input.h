@@ -0,0 +1,309 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace Aoc {
+
+// Splits a buffer into '\n' terminated lines without copying. Behaves like a
+// std::getline loop: a trailing newline does not produce an extra empty line.
+class Lines
+{
+    std::string_view data;
+
+public:
+    class iterator
+    {
+        std::string_view rest;
+        std::string_view line;
+        bool done{true};
+
+        constexpr void advance() noexcept
+        {
+            if (rest.empty()) {
+                done = true;
+                return;
+            }
+            const auto eol{rest.find('\n')};
+            line = rest.substr(0, eol);
+            rest = eol == std::string_view::npos ? std::string_view{} : rest.substr(eol + 1);
+        }
+
+    public:
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+
+        constexpr iterator() noexcept = default;
+        constexpr explicit iterator(std::string_view d) noexcept
+            : rest{d}
+            , done{false}
+        {
+            advance();
+        }
+
+        constexpr std::string_view operator*() const noexcept { return line; }
+
+        constexpr iterator& operator++() noexcept
+        {
+            advance();
+            return *this;
+        }
+
+        constexpr iterator operator++(int) noexcept
+        {
+            auto tmp{*this};
+            advance();
+            return tmp;
+        }
+
+        // Remaining unread bytes after the current line.
+        constexpr std::string_view remainder() const noexcept { return rest; }
+
+        constexpr bool operator==(iterator const& o) const noexcept
+        {
+            return done == o.done && (done || line.data() == o.line.data());
+        }
+        constexpr bool operator==(std::default_sentinel_t) const noexcept { return done; }
+    };
+
+    constexpr Lines() noexcept = default;
+    constexpr explicit Lines(std::string_view d) noexcept
+        : data{d}
+    { }
+
+    constexpr iterator begin() const noexcept { return iterator{data}; }
+    constexpr std::default_sentinel_t end() const noexcept { return {}; }
+};
+
+
+// Splits a buffer into blank-line separated records (e.g. the two sections of
+// day5). Each record keeps its inner newlines but not the separator.
+class Records
+{
+    std::string_view data;
+
+public:
+    class iterator
+    {
+        std::string_view rest;
+        std::string_view record;
+        bool done{true};
+
+        constexpr void advance() noexcept
+        {
+            while (rest.starts_with('\n')) {
+                rest.remove_prefix(1);
+            }
+            if (rest.empty()) {
+                done = true;
+                return;
+            }
+            const auto sep{rest.find("\n\n")};
+            record = rest.substr(0, sep);
+            rest = sep == std::string_view::npos ? std::string_view{} : rest.substr(sep + 2);
+            if (record.ends_with('\n')) {
+                record.remove_suffix(1);
+            }
+        }
+
+    public:
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+
+        constexpr iterator() noexcept = default;
+        constexpr explicit iterator(std::string_view d) noexcept
+            : rest{d}
+            , done{false}
+        {
+            advance();
+        }
+
+        constexpr std::string_view operator*() const noexcept { return record; }
+
+        constexpr iterator& operator++() noexcept
+        {
+            advance();
+            return *this;
+        }
+
+        constexpr iterator operator++(int) noexcept
+        {
+            auto tmp{*this};
+            advance();
+            return tmp;
+        }
+
+        constexpr bool operator==(iterator const& o) const noexcept
+        {
+            return done == o.done && (done || record.data() == o.record.data());
+        }
+        constexpr bool operator==(std::default_sentinel_t) const noexcept { return done; }
+    };
+
+    constexpr Records() noexcept = default;
+    constexpr explicit Records(std::string_view d) noexcept
+        : data{d}
+    { }
+
+    constexpr iterator begin() const noexcept { return iterator{data}; }
+    constexpr std::default_sentinel_t end() const noexcept { return {}; }
+};
+
+
+// Whole puzzle input as one read-only buffer. Regular files (including a file
+// redirected to stdin) are memory mapped; pipes are read into memory once.
+class MappedInput
+{
+    void* map{MAP_FAILED};
+    size_t length{0};
+    std::string buffer;
+    std::string_view view;
+
+    bool map_fd(int fd)
+    {
+        struct stat st{};
+        if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+            return false;
+        }
+
+        length = st.st_size;
+        if (length == 0) {
+            return true;
+        }
+
+        map = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+        if (map == MAP_FAILED) {
+            length = 0;
+            return false;
+        }
+        ::madvise(map, length, MADV_SEQUENTIAL);
+        view = {static_cast<const char*>(map), length};
+        return true;
+    }
+
+    void read_stdin()
+    {
+        if (map_fd(STDIN_FILENO)) {
+            return;
+        }
+        buffer.assign(std::istreambuf_iterator<char>{std::cin}, std::istreambuf_iterator<char>{});
+        view = buffer;
+    }
+
+public:
+    MappedInput() { read_stdin(); }
+
+    explicit MappedInput(std::string const& path)
+    {
+        const int fd{::open(path.c_str(), O_RDONLY)};
+        if (fd < 0) {
+            throw std::runtime_error("Unable to open " + path);
+        }
+        const bool mapped{map_fd(fd)};
+        ::close(fd);
+        if (!mapped) {
+            throw std::runtime_error("Unable to map " + path);
+        }
+    }
+
+    // Input file from the first argument, stdin otherwise.
+    MappedInput(int argc, char** argv)
+    {
+        if (argc > 1 && std::string_view{argv[1]} != "-") {
+            *this = MappedInput{std::string{argv[1]}};
+        }
+        else {
+            read_stdin();
+        }
+    }
+
+    MappedInput(MappedInput const&) = delete;
+    MappedInput& operator=(MappedInput const&) = delete;
+
+    MappedInput(MappedInput&& o) noexcept { *this = std::move(o); }
+
+    MappedInput& operator=(MappedInput&& o) noexcept
+    {
+        if (this != &o) {
+            unmap();
+            map = std::exchange(o.map, MAP_FAILED);
+            length = std::exchange(o.length, 0);
+            buffer = std::move(o.buffer);
+            view = map != MAP_FAILED ? std::string_view{static_cast<const char*>(map), length}
+                                     : std::string_view{buffer};
+            o.view = {};
+        }
+        return *this;
+    }
+
+    ~MappedInput() { unmap(); }
+
+    std::string_view data() const noexcept { return view; }
+    Lines lines() const noexcept { return Lines{view}; }
+    Records records() const noexcept { return Records{view}; }
+
+private:
+    void unmap() noexcept
+    {
+        if (map != MAP_FAILED) {
+            ::munmap(map, length);
+            map = MAP_FAILED;
+        }
+    }
+};
+
+
+// Reads fd to the end in chunks as the data arrives (a pipe from a generator
+// works) and calls on_line for every line, the last one even without '\n',
+// until on_line returns false. Memory stays at one chunk, or the longest
+// line if that is longer.
+template<typename OnLine>
+void read_lines(int fd, OnLine&& on_line, size_t chunk = 256 * 1024)
+{
+    std::vector<char> buffer(chunk);
+    size_t kept{0};  // unfinished line moved to the front
+
+    for (;;) {
+        if (kept == buffer.size()) {
+            buffer.resize(buffer.size() * 2);
+        }
+        const ssize_t n{::read(fd, buffer.data() + kept, buffer.size() - kept)};
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error(std::string{"Unable to read input: "} + std::strerror(errno));
+        }
+        if (n == 0) {
+            if (kept) {
+                on_line(std::string_view{buffer.data(), kept});
+            }
+            return;
+        }
+
+        std::string_view data{buffer.data(), kept + n};
+        for (auto eol{data.find('\n')}; eol != std::string_view::npos; eol = data.find('\n')) {
+            if (!on_line(data.substr(0, eol))) {
+                return;
+            }
+            data.remove_prefix(eol + 1);
+        }
+        kept = data.size();
+        std::memmove(buffer.data(), data.data(), kept);
+    }
+}
+
+}  // namespace Aoc
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <ranges>
+
+namespace Aoc {
+
+// closed interval [from, to]
+template<typename T>
+struct Interval
+{
+    T from{0}, to{0};
+
+    constexpr auto operator<=>(Interval const&) const = default;
+};
+
+
+// Sorts the intervals, drops the empty ones (from > to) and joins the
+// overlapping or touching ones, returns how many disjoint intervals are left
+// at the front. Touching is tested without to + 1, which would wrap for an
+// interval ending at the largest T.
+template<std::ranges::random_access_range R>
+constexpr size_t merge(R&& intervals)
+{
+    std::ranges::sort(intervals);
+
+    size_t count{0};
+    for (auto const& r : intervals) {
+        if (r.from > r.to) {
+            continue;
+        }
+        if (count && (r.from <= intervals[count - 1].to || r.from - 1 == intervals[count - 1].to)) {
+            intervals[count - 1].to = std::max(intervals[count - 1].to, r.to);
+        }
+        else {
+            intervals[count++] = r;
+        }
+    }
+    return count;
+}
+
+}  // namespace Aoc
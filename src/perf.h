@@ -0,0 +1,354 @@
+#pragma once
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if AOC_PERF
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Hardware counters (perf_event_open) around named scopes. Built with
+// -DAOC_PERF=ON every scope adds the cycles, instructions, cache and branch
+// misses of the calling thread to its site; without it the scopes compile
+// to nothing. Counters the kernel refuses (no PMU in a VM, perf_event_paranoid,
+// seccomp) are reported as n/a, the rest keep working.
+//
+//   AOC_PERF_SCOPE("day10/iterate_joltage");
+//
+// Recursive functions only count the outermost call, so the totals are
+// inclusive and never counted twice.
+namespace Aoc::Perf {
+
+enum Event : size_t
+{
+    Cycles,
+    Instructions,
+    L1dMisses,
+    LlcMisses,
+    BranchMisses,
+    Events
+};
+
+inline constexpr std::array<std::string_view, Events> event_names{
+        "cycles", "instructions", "L1d-misses", "LLC-misses", "branch-misses"};
+
+using Values = std::array<uint64_t, Events>;
+
+struct Totals
+{
+    uint64_t calls{0};
+    Values values{};
+};
+
+#if AOC_PERF
+
+inline constexpr bool enabled{true};
+
+// Counters of the calling thread, one fd per event. A counter that could not
+// be opened keeps fd -1 and reads as 0.
+class Counters
+{
+    std::array<int, Events> fds;
+    int error{0};  // errno of the first counter that failed to open
+
+    int open(uint32_t type, uint64_t config)
+    {
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        const int fd{static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0))};
+        if (fd < 0 && !error) {
+            error = errno;
+        }
+        return fd;
+    }
+
+public:
+    Counters()
+    {
+        constexpr uint64_t l1d_read_miss{
+                PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)};
+
+        fds[Cycles] = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        fds[Instructions] = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        fds[L1dMisses] = open(PERF_TYPE_HW_CACHE, l1d_read_miss);
+        fds[LlcMisses] = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        fds[BranchMisses] = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+    }
+
+    Counters(Counters const&) = delete;
+    Counters& operator=(Counters const&) = delete;
+
+    ~Counters()
+    {
+        for (int fd : fds) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+        }
+    }
+
+    bool available(Event e) const noexcept { return fds[e] >= 0; }
+
+    int open_error() const noexcept { return error; }
+
+    // Current values, scaled up when the kernel had to multiplex the counters.
+    Values read() const noexcept
+    {
+        Values values{};
+        for (size_t e{0}; e < Events; ++e) {
+            uint64_t buf[3];  // value, time enabled, time running
+            if (fds[e] < 0 || ::read(fds[e], buf, sizeof(buf)) != sizeof(buf)) {
+                continue;
+            }
+            values[e] = buf[2] && buf[2] < buf[1] ? static_cast<uint64_t>(double(buf[0]) * buf[1] / buf[2]) : buf[0];
+        }
+        return values;
+    }
+
+    static Counters& local()
+    {
+        thread_local Counters counters;
+        return counters;
+    }
+};
+
+
+class Registry;
+
+// Totals of one thread, merged into the registry when the thread exits.
+struct ThreadTotals
+{
+    std::vector<Totals> sites;
+    std::vector<uint32_t> depth;
+
+    ThreadTotals();
+    ~ThreadTotals();
+
+    static ThreadTotals& local()
+    {
+        thread_local ThreadTotals totals;
+        return totals;
+    }
+};
+
+
+class Registry
+{
+    mutable std::mutex mutex;
+    std::deque<std::string> names;
+    std::vector<Totals> finished;
+    std::vector<ThreadTotals const*> running;
+
+    static void add(std::vector<Totals>& to, std::vector<Totals> const& from)
+    {
+        to.resize(std::max(to.size(), from.size()));
+        for (size_t i{0}; i < from.size(); ++i) {
+            to[i].calls += from[i].calls;
+            for (size_t e{0}; e < Events; ++e) {
+                to[i].values[e] += from[i].values[e];
+            }
+        }
+    }
+
+public:
+    // never destroyed: pool threads may exit after the static destructors ran
+    static Registry& instance()
+    {
+        static Registry* registry{new Registry};
+        return *registry;
+    }
+
+    // Id of the site with the given name, created on first use.
+    size_t site(std::string_view name)
+    {
+        const std::lock_guard lock{mutex};
+        for (size_t i{0}; i < names.size(); ++i) {
+            if (names[i] == name) {
+                return i;
+            }
+        }
+        names.emplace_back(name);
+        return names.size() - 1;
+    }
+
+    void attach(ThreadTotals const* t)
+    {
+        const std::lock_guard lock{mutex};
+        running.push_back(t);
+    }
+
+    void detach(ThreadTotals const* t)
+    {
+        const std::lock_guard lock{mutex};
+        add(finished, t->sites);
+        std::erase(running, t);
+    }
+
+    // Names and totals of all sites over all threads so far. Threads still
+    // running are read without stopping them, call it between runs.
+    std::vector<std::pair<std::string, Totals>> snapshot() const
+    {
+        const std::lock_guard lock{mutex};
+        std::vector<Totals> all{finished};
+        for (auto const* t : running) {
+            add(all, t->sites);
+        }
+
+        std::vector<std::pair<std::string, Totals>> result;
+        for (size_t i{0}; i < names.size(); ++i) {
+            result.emplace_back(names[i], i < all.size() ? all[i] : Totals{});
+        }
+        return result;
+    }
+};
+
+
+inline ThreadTotals::ThreadTotals()
+{
+    Registry::instance().attach(this);
+}
+
+inline ThreadTotals::~ThreadTotals()
+{
+    Registry::instance().detach(this);
+}
+
+
+inline size_t site(std::string_view name)
+{
+    return Registry::instance().site(name);
+}
+
+
+class Scope
+{
+    ThreadTotals& totals;
+    size_t id;
+    bool outermost;
+    Values start;
+
+public:
+    explicit Scope(size_t site_id)
+        : totals {ThreadTotals::local()}
+        , id {site_id}
+    {
+        if (totals.sites.size() <= id) {
+            totals.sites.resize(id + 1);
+            totals.depth.resize(id + 1);
+        }
+        ++totals.sites[id].calls;
+        outermost = totals.depth[id]++ == 0;
+        if (outermost) {
+            start = Counters::local().read();
+        }
+    }
+
+    Scope(Scope const&) = delete;
+    Scope& operator=(Scope const&) = delete;
+
+    ~Scope()
+    {
+        --totals.depth[id];
+        if (!outermost) {
+            return;
+        }
+        const auto end{Counters::local().read()};
+        for (size_t e{0}; e < Events; ++e) {
+            totals.sites[id].values[e] += end[e] - start[e];
+        }
+    }
+};
+
+
+// Table of all sites with at least one call.
+inline void report(std::FILE* out = stdout)
+{
+    auto const& counters{Counters::local()};
+    if (counters.open_error()) {
+        fmt::print(out, "some counters are not available: {}\n", std::strerror(counters.open_error()));
+    }
+
+    auto cell = [&counters](Event e, uint64_t value)
+    { return counters.available(e) ? fmt::format("{}", value) : std::string{"n/a"}; };
+
+    fmt::print(out,
+               "{:<32} {:>10} {:>16} {:>16} {:>6} {:>14} {:>14} {:>14}\n",
+               "scope",
+               "calls",
+               event_names[Cycles],
+               event_names[Instructions],
+               "IPC",
+               event_names[L1dMisses],
+               event_names[LlcMisses],
+               event_names[BranchMisses]);
+
+    for (auto const& [name, t] : Registry::instance().snapshot()) {
+        if (!t.calls) {
+            continue;
+        }
+        const bool ipc{counters.available(Cycles) && counters.available(Instructions) && t.values[Cycles]};
+        fmt::print(out,
+                   "{:<32} {:>10} {:>16} {:>16} {:>6} {:>14} {:>14} {:>14}\n",
+                   name,
+                   t.calls,
+                   cell(Cycles, t.values[Cycles]),
+                   cell(Instructions, t.values[Instructions]),
+                   ipc ? fmt::format("{:.2f}", double(t.values[Instructions]) / t.values[Cycles]) : "n/a",
+                   cell(L1dMisses, t.values[L1dMisses]),
+                   cell(LlcMisses, t.values[LlcMisses]),
+                   cell(BranchMisses, t.values[BranchMisses]));
+    }
+}
+
+#define AOC_PERF_CAT_(a, b) a##b
+#define AOC_PERF_CAT(a, b) AOC_PERF_CAT_(a, b)
+#define AOC_PERF_SCOPE(name)                                                               \
+    static const size_t AOC_PERF_CAT(aoc_perf_site_, __LINE__){::Aoc::Perf::site(name)}; \
+    const ::Aoc::Perf::Scope AOC_PERF_CAT(aoc_perf_scope_, __LINE__)                      \
+    {                                                                                      \
+        AOC_PERF_CAT(aoc_perf_site_, __LINE__)                                             \
+    }
+
+#else
+
+inline constexpr bool enabled{false};
+
+inline size_t site(std::string_view)
+{
+    return 0;
+}
+
+struct Scope
+{
+    explicit Scope(size_t) { }
+};
+
+inline void report(std::FILE* out = stdout)
+{
+    fmt::print(out, "hardware counters not built in, configure with -DAOC_PERF=ON\n");
+}
+
+#define AOC_PERF_SCOPE(name) static_cast<void>(0)
+
+#endif
+
+}  // namespace Aoc::Perf
@@ -1,9 +1,17 @@
+#pragma once
+
 #include <boost/container_hash/hash.hpp>
 
+#include <algorithm>
+#include <cassert>
 #include <compare>
 #include <concepts>
+#include <cstddef>
 #include <cstdint>
+#include <span>
+#include <string_view>
 #include <type_traits>
+#include <vector>
 
 namespace Gfx_2d {
 
@@ -122,9 +130,133 @@ struct Point
         boost::hash_combine(seed, p.y);
         return seed;
     }
+
+    // both coordinates in one word, for Aoc::FlatSet/FlatMap
+    friend constexpr uint64_t packed_key(Point const& p) noexcept
+    {
+        static_assert(sizeof(Coord) <= 4, "packed_key needs coordinates of at most 32 bits");
+        return static_cast<uint64_t>(static_cast<uint32_t>(p.x)) << 32 | static_cast<uint32_t>(p.y);
+    }
 };
 
 
+// Dense row-major grid of width x height cells, optionally surrounded by a
+// border of `padding` cells on every side. With a border, the neighbours of
+// any cell inside the grid can be read without bounds checks, either as
+// grid[p + dir] or, in inner loops, as cells()[index + offset(dir)].
+template<typename T>
+class Grid
+{
+    int64_t w{0}, h{0}, pad{0}, stride{0};
+    std::vector<T> storage;
+
+public:
+    using value_type = T;
+
+    Grid() = default;
+
+    Grid(int64_t width, int64_t height, T const& fill = {}, int64_t padding = 0, T const& border = {})
+        : w {width}
+        , h {height}
+        , pad {padding}
+        , stride {width + 2 * padding}
+        , storage(static_cast<size_t>(stride * (height + 2 * padding)), border)
+    {
+        for (int64_t y{0}; y < h; ++y) {
+            std::ranges::fill(row(y), fill);
+        }
+    }
+
+    // One cell per character of each line up to the first empty one; the
+    // grid is as wide as the longest line, shorter lines are filled with
+    // cell(' ').
+    template<typename Fn>
+    static Grid from_text(std::string_view text, Fn&& cell, int64_t padding = 0, T const& border = {})
+    {
+        std::vector<std::string_view> lines;
+        size_t width{0};
+        while (!text.empty()) {
+            const auto eol{text.find('\n')};
+            const auto line{text.substr(0, eol)};
+            if (line.empty()) {
+                break;
+            }
+            lines.push_back(line);
+            width = std::max(width, line.size());
+            text.remove_prefix(eol == std::string_view::npos ? text.size() : eol + 1);
+        }
+
+        Grid grid(static_cast<int64_t>(width), std::ssize(lines), cell(' '), padding, border);
+        for (int64_t y{0}; y < grid.h; ++y) {
+            auto r{grid.row(y)};
+            for (size_t x{0}; x < lines[y].size(); ++x) {
+                r[x] = cell(lines[y][x]);
+            }
+        }
+        return grid;
+    }
+
+    constexpr int64_t width() const noexcept { return w; }
+    constexpr int64_t height() const noexcept { return h; }
+    constexpr int64_t padding() const noexcept { return pad; }
+
+    // inside the grid proper, the border does not count
+    template<std::integral Coord>
+    constexpr bool inside(Point<Coord> const& p) const noexcept
+    {
+        return p.x >= 0 && p.x < w && p.y >= 0 && p.y < h;
+    }
+
+    // index into cells(), valid for points inside the grid and its border
+    template<std::integral Coord>
+    constexpr size_t index(Point<Coord> const& p) const noexcept
+    {
+        return static_cast<size_t>((p.y + pad) * stride + p.x + pad);
+    }
+
+    template<std::integral Coord = int64_t>
+    constexpr Point<Coord> point(size_t index) const noexcept
+    {
+        const auto i{static_cast<int64_t>(index)};
+        return {static_cast<Coord>(i % stride - pad), static_cast<Coord>(i / stride - pad)};
+    }
+
+    // index distance to the neighbour in direction d
+    constexpr ptrdiff_t offset(Direction const& d) const noexcept { return d.dy * stride + d.dx; }
+
+    template<std::integral Coord>
+    T& operator[](Point<Coord> const& p) noexcept
+    {
+        assert(index(p) < storage.size());
+        return storage[index(p)];
+    }
+
+    template<std::integral Coord>
+    T const& operator[](Point<Coord> const& p) const noexcept
+    {
+        assert(index(p) < storage.size());
+        return storage[index(p)];
+    }
+
+    // cell at p, or fallback outside the grid
+    template<std::integral Coord>
+    T get(Point<Coord> const& p, T const& fallback) const noexcept
+    {
+        return inside(p) ? storage[index(p)] : fallback;
+    }
+
+    // all cells including the border, row by row
+    std::span<T> cells() noexcept { return storage; }
+    std::span<const T> cells() const noexcept { return storage; }
+
+    // row y without its border
+    std::span<T> row(int64_t y) noexcept { return std::span{storage}.subspan(index(Point<int64_t>{0, y}), w); }
+    std::span<const T> row(int64_t y) const noexcept
+    {
+        return std::span{storage}.subspan(index(Point<int64_t>{0, y}), w);
+    }
+};
+
 }  // namespace Gfx_2d
 
 template<>
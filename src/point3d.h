@@ -1,8 +1,17 @@
+#pragma once
+
 #include <boost/container_hash/hash.hpp>
 
+#include <algorithm>
+#include <cassert>
+#include <cmath>
 #include <compare>
 #include <concepts>
+#include <cstdint>
+#include <memory_resource>
+#include <ranges>
 #include <type_traits>
+#include <vector>
 
 namespace Gfx_3d {
 
@@ -77,9 +86,16 @@ struct Point
         return std::abs(x - o.x) + std::abs(y - o.y) + std::abs(z - o.z);
     }
 
-    [[nodiscard]] constexpr double euclidean_dist(Point const& o) const noexcept
+    // exact, orders points like euclidean_dist
+    [[nodiscard]] constexpr int64_t squared_dist(Point const& o) const noexcept
     {
-        return std::sqrt(std::pow(x - o.x, 2) + std::pow(y - o.y, 2) + std::pow(z - o.z, 2));
+        const int64_t dx{x - o.x}, dy{y - o.y}, dz{z - o.z};
+        return dx * dx + dy * dy + dz * dz;
+    }
+
+    [[nodiscard]] double euclidean_dist(Point const& o) const noexcept
+    {
+        return std::sqrt(static_cast<double>(squared_dist(o)));
     }
 
     friend size_t hash_value(Gfx_3d::Point<Coord> const& p) noexcept {
@@ -89,6 +105,108 @@ struct Point
         boost::hash_combine(seed, p.z);
         return seed;
     }
+
+    // 21 bits per coordinate, for Aoc::FlatSet/FlatMap; coordinates must
+    // lie in [-2^20, 2^20)
+    friend constexpr uint64_t packed_key(Point const& p) noexcept
+    {
+        constexpr int64_t bias{1 << 20};
+        auto field = [](int64_t v)
+        {
+            assert(v >= -bias && v < bias);
+            return static_cast<uint64_t>(v + bias);
+        };
+        return field(p.x) << 42 | field(p.y) << 21 | field(p.z);
+    }
+};
+
+
+// The same points as separate x, y and z arrays. The distance kernels walk
+// them as three contiguous streams in plain loops the compiler vectorises
+// (wider with -DAOC_MARCH=native), in exact integer squared distances.
+template<std::integral Coord>
+class PointCloud
+{
+    std::pmr::vector<Coord> xs, ys, zs;
+
+public:
+    using Distance = int64_t;  // squared
+
+    explicit PointCloud(std::pmr::memory_resource* r = std::pmr::get_default_resource())
+        : xs {r}
+        , ys {r}
+        , zs {r}
+    { }
+
+    template<std::ranges::sized_range Points>
+    explicit PointCloud(Points const& points, std::pmr::memory_resource* r = std::pmr::get_default_resource())
+        : PointCloud {r}
+    {
+        reserve(std::ranges::size(points));
+        for (auto const& p : points) {
+            push_back(p);
+        }
+    }
+
+    void reserve(size_t n)
+    {
+        xs.reserve(n);
+        ys.reserve(n);
+        zs.reserve(n);
+    }
+
+    void push_back(Point<Coord> const& p)
+    {
+        xs.push_back(p.x);
+        ys.push_back(p.y);
+        zs.push_back(p.z);
+    }
+
+    size_t size() const noexcept { return xs.size(); }
+
+    Point<Coord> operator[](size_t i) const noexcept { return {xs[i], ys[i], zs[i]}; }
+
+    Distance squared_dist(size_t i, size_t j) const noexcept { return (*this)[i].squared_dist((*this)[j]); }
+
+    // Squared distances from point i to each of the points [from, to), into out.
+    void distance_row(size_t i, size_t from, size_t to, Distance* __restrict out) const noexcept
+    {
+        const Coord* __restrict x{xs.data()};
+        const Coord* __restrict y{ys.data()};
+        const Coord* __restrict z{zs.data()};
+        const Distance px{x[i]}, py{y[i]}, pz{z[i]};
+
+        for (size_t j{from}; j < to; ++j) {
+            const Distance dx{x[j] - px}, dy{y[j] - py}, dz{z[j] - pz};
+            out[j - from] = dx * dx + dy * dy + dz * dz;
+        }
+    }
+
+    // Calls on_pair(i, j, squared distance) once for every i < j. Goes tile
+    // by tile, so that for large clouds both blocks of points stay in cache
+    // while their rows are computed.
+    template<typename OnPair>
+    void all_pairs(OnPair&& on_pair, size_t tile = 1024) const
+    {
+        std::vector<Distance> row(tile);
+
+        for (size_t bi{0}; bi < size(); bi += tile) {
+            const size_t ei{std::min(bi + tile, size())};
+            for (size_t bj{bi}; bj < size(); bj += tile) {
+                const size_t ej{std::min(bj + tile, size())};
+                for (size_t i{bi}; i < ei; ++i) {
+                    const size_t from{std::max(bj, i + 1)};
+                    if (from >= ej) {
+                        continue;
+                    }
+                    distance_row(i, from, ej, row.data());
+                    for (size_t j{from}; j < ej; ++j) {
+                        on_pair(i, j, row[j - from]);
+                    }
+                }
+            }
+        }
+    }
 };
 
 }  // namespace Gfx_3d
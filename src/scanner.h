@@ -0,0 +1,233 @@
+#pragma once
+
+#include <bit>
+#include <charconv>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace Aoc {
+
+namespace detail {
+
+// SWAR helpers: eight ASCII characters loaded as one little endian word.
+constexpr bool is_eight_digits(uint64_t chunk) noexcept
+{
+    return ((chunk & 0xF0F0F0F0F0F0F0F0) | (((chunk + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4))
+            == 0x3333333333333333;
+}
+
+constexpr uint32_t parse_eight_digits(uint64_t chunk) noexcept
+{
+    chunk -= 0x3030303030303030;
+    chunk = (chunk * 10) + (chunk >> 8);
+    chunk = (((chunk & 0x000000FF000000FF) * 0x000F424000000064)
+             + (((chunk >> 16) & 0x000000FF000000FF) * 0x0000271000000001))
+            >> 32;
+    return static_cast<uint32_t>(chunk);
+}
+
+constexpr uint64_t pow10[] {
+        1ull,
+        10ull,
+        100ull,
+        1000ull,
+        10000ull,
+        100000ull,
+        1000000ull,
+        10000000ull,
+        100000000ull,
+        1000000000ull,
+        10000000000ull,
+        100000000000ull,
+        1000000000000ull,
+        10000000000000ull,
+        100000000000000ull,
+        1000000000000000ull,
+        10000000000000000ull,
+        100000000000000000ull,
+        1000000000000000000ull,
+        10000000000000000000ull};
+
+constexpr bool is_digit(char c) noexcept
+{
+    return c >= '0' && c <= '9';
+}
+
+}  // namespace detail
+
+
+// Parses the digits at [first, last) into value, from_chars style: ptr is
+// the position after the last digit, or first with invalid_argument if there
+// is no digit. A number too large for T leaves value alone and reports
+// result_out_of_range with ptr past all its digits. In constant evaluation
+// (embedded inputs) it falls back to one digit at a time.
+template<std::unsigned_integral T>
+constexpr std::from_chars_result parse_digits(const char* first, const char* last, T& value) noexcept
+{
+    constexpr T max{std::numeric_limits<T>::max()};
+    const char* p{first};
+
+    const auto out_of_range{[&]
+    {
+        while (p != last && detail::is_digit(*p)) {
+            ++p;
+        }
+        return std::from_chars_result{p, std::errc::result_out_of_range};
+    }};
+
+    if consteval {
+        T acc{0};
+        while (p != last && detail::is_digit(*p)) {
+            const T digit = *p - '0';
+            if (acc > (max - digit) / 10) {
+                return out_of_range();
+            }
+            acc = acc * 10 + digit;
+            ++p;
+        }
+        if (p == first) {
+            return {first, std::errc::invalid_argument};
+        }
+        value = acc;
+        return {p, std::errc{}};
+    }
+
+    uint64_t acc{0};
+    if constexpr (std::endian::native == std::endian::little && sizeof(T) >= sizeof(uint32_t)) {
+        while (last - p >= 8) {
+            uint64_t chunk;
+            std::memcpy(&chunk, p, sizeof(chunk));
+            if (!detail::is_eight_digits(chunk)) {
+                break;
+            }
+            const uint64_t eight{detail::parse_eight_digits(chunk)};
+            if (acc > (UINT64_MAX - eight) / 100000000) {
+                return out_of_range();
+            }
+            acc = acc * 100000000 + eight;
+            p += 8;
+        }
+    }
+
+    T tail{0};
+    auto [end, ec] {std::from_chars(p, last, tail)};
+    if (ec == std::errc::result_out_of_range) {
+        return out_of_range();
+    }
+    if (ec != std::errc{}) {
+        if (p == first) {
+            return {first, std::errc::invalid_argument};
+        }
+        end = p;
+    }
+    if (p == first) {
+        value = tail;
+        return {end, std::errc{}};
+    }
+
+    // after whole chunks at most 7 digits are left
+    const uint64_t scale{detail::pow10[end - p]};
+    p = end;
+    if (acc > (max - tail) / scale) {
+        return out_of_range();
+    }
+    value = static_cast<T>(acc * scale + tail);
+    return {end, std::errc{}};
+}
+
+
+// Sequential integer reader over a string_view. Anything that is not a digit
+// acts as a separator, so "1,2", "3-4", "5 6" and "7x8: 9" all scan alike.
+// For signed types a '-' directly in front of a digit is taken as the sign.
+// A number that does not fit the type throws std::out_of_range, as stoull
+// did, rather than reading like the end of the input.
+class Scanner
+{
+    const char* begin;
+    const char* pos;
+    const char* end;
+
+public:
+    constexpr explicit Scanner(std::string_view s) noexcept
+        : begin {s.data()}
+        , pos {s.data()}
+        , end {s.data() + s.size()}
+    { }
+
+    constexpr bool empty() const noexcept { return pos == end; }
+    constexpr std::string_view rest() const noexcept { return {pos, static_cast<size_t>(end - pos)}; }
+
+private:
+    // the number at [first, pos)
+    [[noreturn]] void out_of_range(const char* first) const
+    {
+        throw std::out_of_range(std::string{"Number out of range: "} + std::string{first, pos});
+    }
+
+public:
+
+    template<std::integral T>
+    constexpr bool next(T& value)
+    {
+        while (pos != end && !detail::is_digit(*pos)) {
+            ++pos;
+        }
+        if (pos == end) {
+            return false;
+        }
+
+        using Magnitude = std::make_unsigned_t<T>;
+        Magnitude magnitude{0};
+        const char* first{pos};
+        const auto [stop, ec] {parse_digits(pos, end, magnitude)};
+        pos = stop;
+        if (ec != std::errc{}) {
+            out_of_range(first);
+        }
+
+        if constexpr (std::is_signed_v<T>) {
+            const bool negative{first != begin && first[-1] == '-'};
+            if (magnitude > static_cast<Magnitude>(std::numeric_limits<T>::max()) + Magnitude{negative}) {
+                out_of_range(first - negative);
+            }
+            if (negative) {
+                value = static_cast<T>(0 - magnitude);
+                return true;
+            }
+        }
+        value = static_cast<T>(magnitude);
+        return true;
+    }
+};
+
+
+// Parses up to out.size() integers from s into out, returns how many were read.
+template<std::integral T, size_t Extent>
+constexpr size_t parse_list(std::string_view s, std::span<T, Extent> out)
+{
+    Scanner scan{s};
+    size_t n{0};
+    while (n < out.size() && scan.next(out[n])) {
+        ++n;
+    }
+    return n;
+}
+
+
+// Parses the first integer found in s, or returns 0.
+template<std::integral T>
+constexpr T to_int(std::string_view s)
+{
+    T value{0};
+    Scanner{s}.next(value);
+    return value;
+}
+
+}  // namespace Aoc
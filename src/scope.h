@@ -0,0 +1,13 @@
+#pragma once
+
+#include "alloc.h"
+#include "perf.h"
+#include "trace.h"
+
+// One annotation for every per-scope instrumentation the build enables
+// (AOC_PERF counters, AOC_ALLOC heap accounting, AOC_TRACE timeline);
+// nothing otherwise.
+#define AOC_SCOPE(name)    \
+    AOC_PERF_SCOPE(name);  \
+    AOC_ALLOC_SCOPE(name); \
+    AOC_TRACE_SCOPE(name)
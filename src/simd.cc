@@ -0,0 +1,321 @@
+#include "simd.h"
+#include "scanner.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define AOC_SIMD_X86 1
+#endif
+
+namespace Aoc::Simd {
+
+namespace {
+
+constexpr bool is_digit(unsigned char c) noexcept
+{
+    return c >= '0' && c <= '9';
+}
+
+// first position of the largest character at or after from
+MaxDigit max_from(std::string_view s, size_t from, unsigned char top)
+{
+    for (size_t i{from}; i < s.size(); ++i) {
+        top = std::max(top, static_cast<unsigned char>(s[i]));
+    }
+    size_t pos{from};
+    while (pos < s.size() && static_cast<unsigned char>(s[pos]) != top) {
+        ++pos;
+    }
+    return {static_cast<char>(top), pos};
+}
+
+
+namespace scalar {
+
+MaxDigit max_digit(std::string_view s)
+{
+    return max_from(s, 0, 0);
+}
+
+size_t find_newline(std::string_view s)
+{
+    return std::min(s.find('\n'), s.size());
+}
+
+uint64_t digits(std::string_view s)
+{
+    uint64_t value{0};
+    Aoc::parse_digits(s.data(), s.data() + s.size(), value);
+    return value;
+}
+
+void column_numbers(const char* grid, size_t stride, size_t rows, size_t count, uint64_t* out)
+{
+    for (size_t col{0}; col < count; ++col) {
+        uint64_t value{0};
+        for (size_t row{0}; row < rows; ++row) {
+            const unsigned char c = grid[row * stride + col];
+            if (is_digit(c)) {
+                value = value * 10 + (c - '0');
+            }
+        }
+        out[col] = value;
+    }
+}
+
+constexpr Kernels kernels{max_digit, find_newline, digits, column_numbers};
+
+}  // namespace scalar
+
+
+#if AOC_SIMD_X86
+
+namespace sse {
+
+__attribute__((target("sse4.2"))) unsigned char horizontal_max(__m128i v)
+{
+    v = _mm_max_epu8(v, _mm_srli_si128(v, 8));
+    v = _mm_max_epu8(v, _mm_srli_si128(v, 4));
+    v = _mm_max_epu8(v, _mm_srli_si128(v, 2));
+    v = _mm_max_epu8(v, _mm_srli_si128(v, 1));
+    return static_cast<unsigned char>(_mm_cvtsi128_si32(v));
+}
+
+// A '9' ends the scan early, nothing can beat it.
+__attribute__((target("sse4.2"))) MaxDigit max_digit(std::string_view s)
+{
+    const char* p{s.data()};
+    const __m128i nine{_mm_set1_epi8('9')};
+    __m128i best{_mm_setzero_si128()};
+
+    size_t i{0};
+    for (; i + 16 <= s.size(); i += 16) {
+        const __m128i v{_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i))};
+        if (const unsigned mask = _mm_movemask_epi8(_mm_cmpeq_epi8(v, nine))) {
+            return {'9', i + std::countr_zero(mask)};
+        }
+        best = _mm_max_epu8(best, v);
+    }
+
+    const unsigned char top{horizontal_max(best)};
+    const auto tail{max_from(s, i, top)};
+    if (!i || static_cast<unsigned char>(tail.digit) != top) {
+        return tail;
+    }
+
+    const __m128i wanted{_mm_set1_epi8(static_cast<char>(top))};
+    for (size_t j{0};; j += 16) {
+        const __m128i v{_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + j))};
+        if (const unsigned mask = _mm_movemask_epi8(_mm_cmpeq_epi8(v, wanted))) {
+            return {static_cast<char>(top), j + std::countr_zero(mask)};
+        }
+    }
+}
+
+__attribute__((target("sse4.2"))) size_t find_newline(std::string_view s)
+{
+    const char* p{s.data()};
+    const __m128i newline{_mm_set1_epi8('\n')};
+
+    size_t i{0};
+    for (; i + 16 <= s.size(); i += 16) {
+        const __m128i v{_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i))};
+        if (const unsigned mask = _mm_movemask_epi8(_mm_cmpeq_epi8(v, newline))) {
+            return i + std::countr_zero(mask);
+        }
+    }
+    while (i < s.size() && p[i] != '\n') {
+        ++i;
+    }
+    return i;
+}
+
+// Up to 16 digits right-aligned in one register, combined pairwise:
+// 16 x 1 -> 8 x 2 -> 4 x 4 -> 2 x 8 digits.
+__attribute__((target("sse4.2"))) uint64_t sixteen_digits(const char* p, size_t n)
+{
+    alignas(16) char buf[16];
+    std::memset(buf, '0', sizeof(buf));
+    std::memcpy(buf + sizeof(buf) - n, p, n);
+
+    __m128i v{_mm_sub_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(buf)), _mm_set1_epi8('0'))};
+    v = _mm_maddubs_epi16(v, _mm_setr_epi8(10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1));
+    v = _mm_madd_epi16(v, _mm_setr_epi16(100, 1, 100, 1, 100, 1, 100, 1));
+    v = _mm_packus_epi32(v, v);
+    v = _mm_madd_epi16(v, _mm_setr_epi16(10000, 1, 10000, 1, 10000, 1, 10000, 1));
+
+    const uint64_t high{static_cast<uint32_t>(_mm_cvtsi128_si32(v))};
+    const uint64_t low{static_cast<uint32_t>(_mm_extract_epi32(v, 1))};
+    return high * 100000000 + low;
+}
+
+__attribute__((target("sse4.2"))) uint64_t digits(std::string_view s)
+{
+    if (s.size() <= 16) {
+        return sixteen_digits(s.data(), s.size());
+    }
+    const size_t head{s.size() - 16};
+    return scalar::digits(s.substr(0, head)) * 10000000000000000 + sixteen_digits(s.data() + head, 16);
+}
+
+// Four columns per register as 32-bit lanes, which hold up to 9 digits.
+__attribute__((target("sse4.2"))) void column_numbers(
+        const char* grid, size_t stride, size_t rows, size_t count, uint64_t* out)
+{
+    if (rows > 9) {
+        scalar::column_numbers(grid, stride, rows, count, out);
+        return;
+    }
+
+    const __m128i zero{_mm_set1_epi32('0')};
+    const __m128i nine{_mm_set1_epi32('9')};
+    const __m128i ten{_mm_set1_epi32(10)};
+
+    size_t col{0};
+    for (; col + 4 <= count; col += 4) {
+        __m128i value{_mm_setzero_si128()};
+        for (size_t row{0}; row < rows; ++row) {
+            uint32_t bytes;
+            std::memcpy(&bytes, grid + row * stride + col, sizeof(bytes));
+            const __m128i c{_mm_cvtepu8_epi32(_mm_cvtsi32_si128(static_cast<int>(bytes)))};
+            const __m128i other{_mm_or_si128(_mm_cmplt_epi32(c, zero), _mm_cmpgt_epi32(c, nine))};
+            const __m128i next{_mm_add_epi32(_mm_mullo_epi32(value, ten), _mm_sub_epi32(c, zero))};
+            value = _mm_blendv_epi8(next, value, other);
+        }
+        alignas(16) uint32_t lanes[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanes), value);
+        for (size_t i{0}; i < 4; ++i) {
+            out[col + i] = lanes[i];
+        }
+    }
+    scalar::column_numbers(grid + col, stride, rows, count - col, out + col);
+}
+
+constexpr Kernels kernels{max_digit, find_newline, digits, column_numbers};
+
+}  // namespace sse
+
+
+namespace avx2 {
+
+__attribute__((target("avx2"))) MaxDigit max_digit(std::string_view s)
+{
+    const char* p{s.data()};
+    const __m256i nine{_mm256_set1_epi8('9')};
+    __m256i best{_mm256_setzero_si256()};
+
+    size_t i{0};
+    for (; i + 32 <= s.size(); i += 32) {
+        const __m256i v{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i))};
+        if (const unsigned mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, nine))) {
+            return {'9', i + std::countr_zero(mask)};
+        }
+        best = _mm256_max_epu8(best, v);
+    }
+    if (!i) {
+        return sse::max_digit(s);
+    }
+
+    const unsigned char top{
+            sse::horizontal_max(_mm_max_epu8(_mm256_castsi256_si128(best), _mm256_extracti128_si256(best, 1)))};
+    const auto tail{sse::max_digit(s.substr(i))};
+    if (static_cast<unsigned char>(tail.digit) > top) {
+        return {tail.digit, i + tail.pos};
+    }
+
+    const __m256i wanted{_mm256_set1_epi8(static_cast<char>(top))};
+    for (size_t j{0};; j += 32) {
+        const __m256i v{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + j))};
+        if (const unsigned mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, wanted))) {
+            return {static_cast<char>(top), j + std::countr_zero(mask)};
+        }
+    }
+}
+
+__attribute__((target("avx2"))) size_t find_newline(std::string_view s)
+{
+    const char* p{s.data()};
+    const __m256i newline{_mm256_set1_epi8('\n')};
+
+    size_t i{0};
+    for (; i + 32 <= s.size(); i += 32) {
+        const __m256i v{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i))};
+        if (const unsigned mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, newline))) {
+            return i + std::countr_zero(mask);
+        }
+    }
+    return i + sse::find_newline(s.substr(i));
+}
+
+// Eight columns per register, otherwise as the SSE version.
+__attribute__((target("avx2"))) void column_numbers(
+        const char* grid, size_t stride, size_t rows, size_t count, uint64_t* out)
+{
+    if (rows > 9) {
+        scalar::column_numbers(grid, stride, rows, count, out);
+        return;
+    }
+
+    const __m256i zero{_mm256_set1_epi32('0')};
+    const __m256i nine{_mm256_set1_epi32('9')};
+    const __m256i ten{_mm256_set1_epi32(10)};
+
+    size_t col{0};
+    for (; col + 8 <= count; col += 8) {
+        __m256i value{_mm256_setzero_si256()};
+        for (size_t row{0}; row < rows; ++row) {
+            const __m256i c{
+                    _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(grid + row * stride + col)))};
+            const __m256i other{_mm256_or_si256(_mm256_cmpgt_epi32(zero, c), _mm256_cmpgt_epi32(c, nine))};
+            const __m256i next{_mm256_add_epi32(_mm256_mullo_epi32(value, ten), _mm256_sub_epi32(c, zero))};
+            value = _mm256_blendv_epi8(next, value, other);
+        }
+        alignas(32) uint32_t lanes[8];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), value);
+        for (size_t i{0}; i < 8; ++i) {
+            out[col + i] = lanes[i];
+        }
+    }
+    sse::column_numbers(grid + col, stride, rows, count - col, out + col);
+}
+
+// digit runs fit one SSE register, AVX2 has nothing to add
+constexpr Kernels kernels{max_digit, find_newline, sse::digits, column_numbers};
+
+}  // namespace avx2
+
+#endif
+
+
+Kernels const& select()
+{
+    const char* cap{std::getenv("AOC_SIMD")};
+    const std::string_view limit{cap ? cap : ""};
+
+#if AOC_SIMD_X86
+    __builtin_cpu_init();
+    if (limit != "scalar" && limit != "sse4.2" && __builtin_cpu_supports("avx2")) {
+        return avx2::kernels;
+    }
+    if (limit != "scalar" && __builtin_cpu_supports("sse4.2")) {
+        return sse::kernels;
+    }
+#endif
+    return scalar::kernels;
+}
+
+}  // namespace
+
+
+Kernels const& kernels()
+{
+    static Kernels const& selected{select()};
+    return selected;
+}
+
+}  // namespace Aoc::Simd
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// Byte kernels over raw input, in AVX2, SSE4.2 and scalar versions (simd.cc).
+// The best version the CPU supports is picked on first use; setting AOC_SIMD
+// to "scalar" or "sse4.2" caps it, e.g. to compare the paths.
+namespace Aoc::Simd {
+
+struct MaxDigit
+{
+    char digit{0};
+    size_t pos{0};  // first occurrence
+};
+
+struct Kernels
+{
+    MaxDigit (*max_digit)(std::string_view);
+    size_t (*find_newline)(std::string_view);
+    uint64_t (*digits)(std::string_view);
+    void (*column_numbers)(const char*, size_t, size_t, size_t, uint64_t*);
+};
+
+Kernels const& kernels();
+
+
+// Largest character of a non-empty run of digits and where it first occurs.
+inline MaxDigit max_digit(std::string_view s)
+{
+    return kernels().max_digit(s);
+}
+
+// Position of the first '\n' in s, s.size() if there is none.
+inline size_t find_newline(std::string_view s)
+{
+    return kernels().find_newline(s);
+}
+
+// Value of a run of at most 19 digits, nothing else. Short runs are not
+// worth a register.
+inline uint64_t digits(std::string_view s)
+{
+    if (s.size() <= 4) {
+        uint64_t value{0};
+        for (const char c : s) {
+            value = value * 10 + (c - '0');
+        }
+        return value;
+    }
+    return kernels().digits(s);
+}
+
+// For each of the count columns of a grid of rows lines stride bytes apart
+// (the first line at grid), the number its digits spell from the top down;
+// other characters are skipped, a column without digits is 0.
+inline void column_numbers(const char* grid, size_t stride, size_t rows, size_t count, uint64_t* out)
+{
+    kernels().column_numbers(grid, stride, rows, count, out);
+}
+
+}  // namespace Aoc::Simd
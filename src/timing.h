@@ -0,0 +1,197 @@
+#pragma once
+
+#include "alloc.h"
+#include "arena.h"
+#include "day.h"
+#include "perf.h"
+#include "trace.h"
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace Aoc {
+
+using Clock = std::chrono::steady_clock;
+using Duration = std::chrono::duration<double, std::milli>;
+
+struct Stats
+{
+    Duration min{}, median{}, max{};
+};
+
+inline Stats summarize(std::vector<Duration> samples)
+{
+    if (samples.empty()) {
+        return {};
+    }
+
+    std::ranges::sort(samples);
+
+    const size_t mid{samples.size() / 2};
+    const Duration median{samples.size() & 1 ? samples[mid] : (samples[mid - 1] + samples[mid]) / 2};
+
+    return {.min = samples.front(), .median = median, .max = samples.back()};
+}
+
+// One-sided Mann-Whitney U test: the probability of seeing `after` at least
+// this much slower than `before` if both came from the same distribution.
+// Exact for small samples (ties count half), normal approximation beyond.
+inline double mann_whitney_slower(std::vector<Duration> const& before, std::vector<Duration> const& after)
+{
+    const size_t m{before.size()}, n{after.size()};
+    if (!m || !n) {
+        return 1.0;
+    }
+
+    double u{0};
+    for (auto const& b : after) {
+        for (auto const& a : before) {
+            u += b > a ? 1.0 : b == a ? 0.5 : 0.0;
+        }
+    }
+
+    if (m * n > 2500) {
+        const double mean{m * n / 2.0};
+        const double sd{std::sqrt(m * n * (m + n + 1) / 12.0)};
+        return 0.5 * std::erfc((u - 0.5 - mean) / sd / std::sqrt(2.0));
+    }
+
+    // ways[j][k]: orderings of i before- and j after-samples with U == k,
+    // built up one before-sample (i) at a time
+    const size_t max_u{m * n};
+    std::vector<std::vector<double>> ways(n + 1, std::vector<double>(max_u + 1, 0.0));
+    for (size_t j{0}; j <= n; ++j) {
+        ways[j][0] = 1;
+    }
+    for (size_t i{1}; i <= m; ++i) {
+        std::vector<std::vector<double>> next(n + 1, std::vector<double>(max_u + 1, 0.0));
+        next[0][0] = 1;
+        for (size_t j{1}; j <= n; ++j) {
+            for (size_t k{0}; k <= i * j; ++k) {
+                // the largest sample is either a before-sample or an after-sample beating all i
+                next[j][k] = ways[j][k] + (k >= i ? next[j - 1][k - i] : 0.0);
+            }
+        }
+        ways = std::move(next);
+    }
+
+    double total{0}, tail{0};
+    for (size_t k{0}; k <= max_u; ++k) {
+        total += ways[n][k];
+        if (k >= static_cast<size_t>(u)) {
+            tail += ways[n][k];
+        }
+    }
+    return tail / total;
+}
+
+
+// Runs fn once and returns its result together with the wall-clock time.
+template<typename Fn>
+auto timed(Fn&& fn)
+{
+    const auto start{Clock::now()};
+    auto result{fn()};
+    return std::make_pair(std::move(result), Duration{Clock::now() - start});
+}
+
+
+struct PhaseTimes
+{
+    std::vector<Duration> parse, part1, part2;
+    Answer answer1{0}, answer2{0};
+};
+
+// Counter and heap accounting of one phase of a day, summed over all runs
+// (warmup included) as the "dayN/phase" sites of perf.h and alloc.h, and
+// one trace.h event per run.
+class PhaseScope
+{
+    Perf::Scope counters;
+    Alloc::Scope heap;
+    Trace::Scope timeline;
+
+public:
+    struct Site
+    {
+        size_t perf{0}, alloc{0}, trace{0};
+
+        Site(unsigned day, std::string_view phase)
+        {
+            if constexpr (Perf::enabled || Alloc::enabled || Trace::enabled) {
+                const auto name{fmt::format("day{}/{}", day, phase)};
+                perf = Perf::site(name);
+                alloc = Alloc::site(name);
+                trace = Trace::site(name);
+            }
+        }
+    };
+
+    explicit PhaseScope(Site const& site)
+        : counters {site.perf}
+        , heap {site.alloc, Alloc::Reach::Process}
+        , timeline {site.trace}
+    { }
+};
+
+
+// Runs parse/part1/part2 of a day warmup + repeat times over the same input,
+// keeping the wall-clock samples of the last repeat runs. Every run gets the
+// same RunArena, reset in between. With builtin the parse phase is
+// day.builtin(), the compiled-in input, and data is ignored.
+inline PhaseTimes measure(Day const& day, std::string_view data, unsigned warmup, unsigned repeat, bool builtin = false)
+{
+    PhaseTimes times;
+    RunArena arena;
+
+    const PhaseScope::Site s_parse{day.number, "parse"}, s_part1{day.number, "part1"}, s_part2{day.number, "part2"};
+
+    for (unsigned run{0}; run < warmup + repeat; ++run) {
+        const bool measured{run >= warmup};
+
+        arena.reset();
+        const RunArena::Use use{arena};
+
+        const auto [parsed, d_parse] {timed(
+                [&]
+                {
+                    const PhaseScope scope{s_parse};
+                    return builtin ? day.builtin() : day.parse(data);
+                })};
+        const auto [a1, d_part1] {timed(
+                [&]
+                {
+                    const PhaseScope scope{s_part1};
+                    return day.part1(parsed);
+                })};
+        times.answer1 = a1;
+
+        if (measured) {
+            times.parse.push_back(d_parse);
+            times.part1.push_back(d_part1);
+        }
+
+        if (day.part2) {
+            const auto [a2, d_part2] {timed(
+                    [&]
+                    {
+                        const PhaseScope scope{s_part2};
+                        return day.part2(parsed);
+                    })};
+            times.answer2 = a2;
+            if (measured) {
+                times.part2.push_back(d_part2);
+            }
+        }
+    }
+
+    return times;
+}
+
+}  // namespace Aoc
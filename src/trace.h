@@ -0,0 +1,247 @@
+#pragma once
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Timeline of named scopes as Chrome trace events (open the file in Perfetto
+// or chrome://tracing). Built with -DAOC_TRACE=ON every scope entered while
+// recording is on appends one complete event, with the calling thread and an
+// optional integer argument, to a buffer owned by that thread, so threads
+// never contend while recording:
+//
+//   AOC_TRACE_SCOPE("day10/iterate_joltage");
+//   AOC_TRACE_SCOPE_ARG("day10/machine", index);
+//
+// Recursive functions only record the outermost call. Without the option the
+// scopes compile to nothing.
+namespace Aoc::Trace {
+
+#if AOC_TRACE
+
+inline constexpr bool enabled{true};
+
+struct Event
+{
+    uint32_t site{0};
+    uint32_t thread{0};
+    int64_t arg{-1};  // negative: none
+    uint64_t begin{0}, end{0};  // ns since the registry was created
+};
+
+
+// Events of one thread, handed to the registry when the thread exits.
+struct ThreadBuffer
+{
+    uint32_t thread{0};
+    std::vector<Event> events;
+    std::vector<uint8_t> open;  // per site: an outermost call is being recorded
+
+    ThreadBuffer();
+    ~ThreadBuffer();
+
+    static ThreadBuffer& local()
+    {
+        thread_local ThreadBuffer buffer;
+        return buffer;
+    }
+};
+
+
+class Registry
+{
+    mutable std::mutex mutex;
+    std::deque<std::string> names;
+    std::vector<Event> finished;
+    std::vector<ThreadBuffer const*> running;
+    uint32_t threads{0};
+    const std::chrono::steady_clock::time_point epoch{std::chrono::steady_clock::now()};
+
+public:
+    std::atomic<bool> recording{false};
+
+    // never destroyed: pool threads may exit after the static destructors ran
+    static Registry& instance()
+    {
+        static Registry* registry{new Registry};
+        return *registry;
+    }
+
+    uint64_t now() const noexcept
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+    }
+
+    size_t site(std::string_view name)
+    {
+        const std::lock_guard lock{mutex};
+        for (size_t i{0}; i < names.size(); ++i) {
+            if (names[i] == name) {
+                return i;
+            }
+        }
+        names.emplace_back(name);
+        return names.size() - 1;
+    }
+
+    uint32_t attach(ThreadBuffer const* t)
+    {
+        const std::lock_guard lock{mutex};
+        running.push_back(t);
+        return threads++;
+    }
+
+    void detach(ThreadBuffer const* t)
+    {
+        const std::lock_guard lock{mutex};
+        finished.insert(finished.end(), t->events.begin(), t->events.end());
+        std::erase(running, t);
+    }
+
+    // Writes all events so far as a trace_event JSON document. Threads still
+    // running are read without stopping them, call it between runs.
+    void write(std::FILE* out) const
+    {
+        const std::lock_guard lock{mutex};
+        std::vector<Event> all{finished};
+        for (auto const* t : running) {
+            all.insert(all.end(), t->events.begin(), t->events.end());
+        }
+        std::ranges::sort(all, {}, &Event::begin);
+
+        fmt::print(out, "{{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+        for (size_t i{0}; i < all.size(); ++i) {
+            auto const& e{all[i]};
+            std::string_view name{names[e.site]};
+            fmt::print(out,
+                       "{{\"name\":\"{}\",\"cat\":\"{}\",\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}",
+                       name,
+                       name.substr(0, name.find('/')),
+                       e.thread,
+                       e.begin / 1e3,
+                       (e.end - e.begin) / 1e3);
+            if (e.arg >= 0) {
+                fmt::print(out, ",\"args\":{{\"index\":{}}}", e.arg);
+            }
+            fmt::print(out, "}}{}\n", i + 1 < all.size() ? "," : "");
+        }
+        fmt::print(out, "]}}\n");
+    }
+};
+
+
+inline ThreadBuffer::ThreadBuffer()
+    : thread {Registry::instance().attach(this)}
+{ }
+
+inline ThreadBuffer::~ThreadBuffer()
+{
+    Registry::instance().detach(this);
+}
+
+
+inline size_t site(std::string_view name)
+{
+    return Registry::instance().site(name);
+}
+
+// Scopes entered from now on are recorded.
+inline void start()
+{
+    Registry::instance().recording.store(true, std::memory_order_relaxed);
+}
+
+
+class Scope
+{
+    ThreadBuffer* buffer{nullptr};  // null when not recording
+    uint32_t id;
+    int64_t arg;
+    uint64_t begin{0};
+
+public:
+    explicit Scope(size_t site_id, int64_t a = -1)
+        : id {static_cast<uint32_t>(site_id)}
+        , arg {a}
+    {
+        auto& registry{Registry::instance()};
+        if (!registry.recording.load(std::memory_order_relaxed)) {
+            return;
+        }
+        auto& b{ThreadBuffer::local()};
+        if (b.open.size() <= id) {
+            b.open.resize(id + 1);
+        }
+        if (!b.open[id]) {
+            b.open[id] = 1;
+            buffer = &b;
+            begin = registry.now();
+        }
+    }
+
+    Scope(Scope const&) = delete;
+    Scope& operator=(Scope const&) = delete;
+
+    ~Scope()
+    {
+        if (!buffer) {
+            return;
+        }
+        buffer->open[id] = 0;
+        buffer->events.push_back(
+                {.site = id, .thread = buffer->thread, .arg = arg, .begin = begin, .end = Registry::instance().now()});
+    }
+};
+
+
+inline void write(std::FILE* out)
+{
+    Registry::instance().write(out);
+}
+
+#define AOC_TRACE_CAT_(a, b) a##b
+#define AOC_TRACE_CAT(a, b) AOC_TRACE_CAT_(a, b)
+#define AOC_TRACE_SCOPE_ARG(name, arg)                                                        \
+    static const size_t AOC_TRACE_CAT(aoc_trace_site_, __LINE__){::Aoc::Trace::site(name)}; \
+    const ::Aoc::Trace::Scope AOC_TRACE_CAT(aoc_trace_scope_, __LINE__)                      \
+    {                                                                                         \
+        AOC_TRACE_CAT(aoc_trace_site_, __LINE__), static_cast<int64_t>(arg)                   \
+    }
+#define AOC_TRACE_SCOPE(name) AOC_TRACE_SCOPE_ARG(name, -1)
+
+#else
+
+inline constexpr bool enabled{false};
+
+inline size_t site(std::string_view)
+{
+    return 0;
+}
+
+inline void start() { }
+
+struct Scope
+{
+    explicit Scope(size_t, int64_t = -1) { }
+};
+
+inline void write(std::FILE* out)
+{
+    fmt::print(out, "{{\"traceEvents\":[]}}\n");
+}
+
+#define AOC_TRACE_SCOPE_ARG(name, arg) static_cast<void>(0)
+#define AOC_TRACE_SCOPE(name) static_cast<void>(0)
+
+#endif
+
+}  // namespace Aoc::Trace